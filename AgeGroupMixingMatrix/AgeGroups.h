@@ -0,0 +1,110 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGE_GROUPS_H
+#define AGE_GROUPS_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+// Age group schemes.  A scheme is the policy that ContactMatrix and ContactTensor are
+// templated on, so for the built-in schemes their sizes are compile-time constants.  Each provides
+//	kNumGroups                the number of groups, or 0 if it is only known at run time
+//	kLabels[a]                group a as it appears in the output
+//	name()                    as in the "Age Groups" configuration key
+//	ageColumn()               the population file column that it classifies
+//	ageToIndex(s, len)        the group of the text s of a value of that column, or -1 after
+//	                          a message to cerr if it isn't one
+//	checksum()                of the definition, to tell apart schemes with the same name; 0 if built in
+// and numGroups() and label(a), which code should call through an instance of the scheme.
+
+struct CDCAgeGroups {
+	enum {kPreschool, kSchool, kAdult, kOlder, kGolden, kNumGroups};
+	static constexpr const char * kLabels[kNumGroups] = {"p", "s", "a", "o", "g"};
+
+	static constexpr int numGroups(void) {return kNumGroups;};
+	static constexpr const char * label(int a) {return kLabels[a];};
+	static const char * name(void) {return "CDC";};
+	static const char * ageColumn(void) {return "age_group";};
+	static int ageToIndex(const char * s, size_t len);
+	static uint32_t checksum(void) {return 0;};
+};
+
+// 5-year groups, the last one 75 and over
+struct PolyModAgeGroups {
+	enum {kNumGroups = 16};
+	// HSM: adjusted number of groups to incorporate 75-79 or 75+
+	static constexpr const char * kLabels[kNumGroups] = {
+		"age_00_04", "age_05_09", "age_10_14", "age_15_19", "age_20_24", "age_25_29",
+		"age_30_34", "age_35_39", "age_40_44", "age_45_49", "age_50_54", "age_55_59",
+		"age_60_64", "age_65_69", "age_70_74", "age_75_79"
+	};
+
+	static constexpr int numGroups(void) {return kNumGroups;};
+	static constexpr const char * label(int a) {return kLabels[a];};
+	static const char * name(void) {return "PolyMod";};
+	static const char * ageColumn(void) {return "age";};
+	static int ageToIndex(const char * s, size_t len);
+	static uint32_t checksum(void) {return 0;};
+};
+
+// A scheme defined at run time by break-points in age: group i holds the ages from its
+// break-point up to the next one, the first break-point is 0 and the last group is open-ended.
+// The definition is compiled into a table from age (the "age" column) to group covering 0 to
+// kMaxAge, so classifying a person is one lookup; anyone older is in the last group.
+// Copies share the definition.
+//
+//	vector<TableAgeGroups> schemes;
+//	if (! TableAgeGroups::readFile(fName, schemes)) ...
+
+class TableAgeGroups {
+	public :
+
+	enum {kNumGroups = 0, kMaxAge = 130, kMaxGroups = kMaxAge + 1};
+
+	TableAgeGroups(void) {};
+	// false, after a message to cerr, unless the break-points increase from 0 to no more than kMaxAge
+	bool define(const string & name, const vector<int> & breaks, const vector<string> & labels);
+
+	int numGroups(void) const {return (fDef) ? fDef->labels.size() : 0;};
+	const char * label(int a) const {return fDef->labels[a].c_str();};
+	const char * name(void) const {return fDef->name.c_str();};
+	const char * ageColumn(void) const {return "age";};
+	int ageToIndex(const char * s, size_t len) const;
+	uint32_t checksum(void) const {return fDef->checksum;};
+
+	// Definitions, one per line: the scheme's name, then each break-point and the label of the
+	// group it starts, as in
+	//	school 0:preschool 5:school 18:adult 65:senior
+	// Blank lines and lines starting with '#' are ignored.  Names are letters, digits, '_' and
+	// '-', and can't be those of the built-in schemes.  False, after reporting why, if it's malformed.
+	static bool readFile(const string & fName, vector<TableAgeGroups> & schemes);
+	// the one named name, or 0
+	static const TableAgeGroups * find(const vector<TableAgeGroups> & schemes, const string & name);
+
+	protected :
+
+	struct Definition {
+		string name;
+		vector<string> labels;
+		uint8_t groups[kMaxAge + 1];   // by age
+		uint32_t checksum;
+	};
+	shared_ptr<const Definition> fDef;
+};
+
+#endif
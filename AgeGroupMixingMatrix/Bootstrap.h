@@ -0,0 +1,110 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H 1
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+#include "Utilities.h"
+
+using namespace std;
+
+// A Poisson bootstrap of the rows of a network, done while it is read: in each of
+// numReplicates resamplings, each row is drawn a Poisson(1) number of times, independently
+// of every other row.  The row is the unit because it is what the matrices count: identical
+// rows are separate contacts, and so is a contact listed once in each direction, which adds
+// to two cells.  The draws are counter-based random numbers keyed on the row's position in
+// the network file (counting from the first line after the header, malformed lines included)
+// and its source, target and duration, and on the seed.  So a row has the same weights
+// however the file is divided among threads, shards and checkpoints, and in an edge file
+// converted from a CSV without malformed lines.  The same row in another file gets other
+// weights, so removing it in an update couldn't take its weights away.
+//
+//	Bootstrap boot(100, seed);
+//	uint8_t w[Bootstrap::kMaxReplicates];
+//	boot.weights(Bootstrap::edgeKey(src, dst, duration, row), w);
+//	for (int r = 0; r < boot.numReplicates(); r++) counts[r] += w[r];
+
+class Bootstrap {
+	public :
+
+	enum {kMaxReplicates = 1000, kMaxWeight = 8};
+
+	Bootstrap(int numReplicates = 0, uint64_t seed = 0) : fNumReplicates(numReplicates), fSeed(seed) {};
+
+	int numReplicates(void) const {return fNumReplicates;};
+	uint64_t seed(void) const {return fSeed;};
+
+	static uint64_t edgeKey(long src, long dst, long duration, long row)
+		{return mix64(mix64(mix64(mix64((uint64_t) src) + (uint64_t) dst) + (uint64_t) duration) + (uint64_t) row);};
+
+	// w[r], for each replicate r, is the number of times the edge is drawn.  Each 64 random bits
+	// make four 16-bit uniforms, turned into weights by comparing them with Poisson(1)'s
+	// cumulative distribution rounded to 1/65536.  Weights are cut off at kMaxWeight, which
+	// only u == 65535 gives: probability 1/65536 (1.5e-5), against 1.0e-5 for 8 or more.
+	void weights(uint64_t key, uint8_t * w) const
+	{
+		for (int r = 0; r < fNumReplicates; r += 4)
+		{
+			const uint64_t bits = counterRandom(key ^ fSeed, r / 4);
+			for (int j = 0; j < 4; j++)
+				w[r + j] = poisson((uint16_t) (bits >> (16 * j)));
+		}
+	};
+
+	// The standard error of a statistic from its values in the replicates, and the limits of
+	// the central level (e.g. 0.95) of them, interpolated.  values is sorted.
+	static void summarize(vector<double> & values, double level, double & se, double & lo, double & hi)
+	{
+		const size_t n = values.size();
+		double mean = 0;
+		for (size_t r = 0; r < n; r++)
+			mean += values[r];
+		mean /= n;
+		double ss = 0;
+		for (size_t r = 0; r < n; r++)
+			ss += (values[r] - mean) * (values[r] - mean);
+		se = (n > 1) ? sqrt(ss / (n - 1)) : 0;
+		sort(values.begin(), values.end());
+		lo = percentile(values, (1 - level) / 2);
+		hi = percentile(values, (1 + level) / 2);
+	};
+
+	protected :
+
+	int fNumReplicates;
+	uint64_t fSeed;
+
+	static uint8_t poisson(uint16_t u)
+	{
+		// 65536 times Poisson(1)'s cumulative probabilities of 0 to 7
+		static const uint16_t kCDF[kMaxWeight] = {24109, 48219, 60273, 64292, 65296, 65497, 65531, 65535};
+		uint8_t rtn = 0;
+		for (int k = 0; k < kMaxWeight; k++)
+			rtn += (u >= kCDF[k]);
+		return rtn;
+	};
+	static double percentile(const vector<double> & sorted, double p)
+	{
+		const double pos = p * (sorted.size() - 1);
+		const size_t i = (size_t) pos;
+		if (i + 1 >= sorted.size())
+			return sorted.back();
+		return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+	};
+};
+
+#endif
@@ -18,46 +18,203 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <utility>
+#include <string>
+#include <string.h>
 #include <iostream>
 #include <fstream>
 
+#include "FieldDecode.h"
+#include "Decompress.h"
+
 // #include "LATypes.h"
 // #include "Person.h"
 
+// One field of the current row.  It points into the parser's line buffer (or into the
+// memory-mapped file), so it is only valid until the parser moves to the next row.
+// Convert it to a std::string if you need to keep it.
+
+class CSVField {
+	public :
+
+	CSVField(void) : fPtr(0), fLen(0) {};
+	CSVField(const char * p, size_t len) : fPtr(p), fLen(len) {};
+
+	const char * data(void) const {return fPtr;};
+	size_t size(void) const {return fLen;};
+	bool empty(void) const {return fLen == 0;};
+	const char * begin(void) const {return fPtr;};
+	const char * end(void) const {return fPtr + fLen;};
+
+	std::string str(void) const {return std::string(fPtr, fLen);};
+	operator std::string() const {return str();};
+
+	// false, leaving val alone, if the field isn't a well-formed number
+	bool toLong(long & val) const {return decodeLong(fPtr, fPtr + fLen, val);};
+	bool toDouble(double & val) const {return decodeDouble(fPtr, fPtr + fLen, val);};
+
+	bool operator==(const char * s) const {return strlen(s) == fLen && memcmp(fPtr, s, fLen) == 0;};
+	bool operator==(const std::string & s) const {return s.length() == fLen && memcmp(fPtr, s.data(), fLen) == 0;};
+	bool operator!=(const char * s) const {return ! (*this == s);};
+	bool operator!=(const std::string & s) const {return ! (*this == s);};
+
+	protected :
+
+	const char * fPtr;
+	size_t fLen;
+};
+
+inline std::ostream & operator<<(std::ostream & os, const CSVField & f)
+{ os.write(f.data(), f.size()); return os; }
+
 // This class reads a <char>-separated values file where
 // <char> can be one of ',', '\t', or ' '
 // FIX:  and can be escaped within a field by prefixing it with a '\'.
-// An iterator reads one line at a time and stores each field in an array of strings.
+// An iterator reads one line at a time and splits it into fields.
 // String field names can be used as indices into the array.
 // The class creates a mapping from field names to indices by parsing the first line,
 // FIX:  first removing any '#' and leading white space characters, unless <char> is ' '.
+//
+// Opened by name, the file is memory-mapped when possible and the fields of each row
+// point straight into the mapping; otherwise lines are read into a reused buffer.
+// A gzip or zstd file is decompressed as it is read (see Decompress.h); it can't be split.
+// Either way, iterating over rows does no allocation once the first row has been read.
+// A mapped file can be split into line-aligned byte ranges, each read by its own parser.
 
 class CSVParser {
 	public :
 
+	enum Mode {kStream, kMapped};
+
 	CSVParser(std::ifstream & is, char sep = ',');
-	CSVParser(const std::string & fName, char sep = ',');
+	CSVParser(const std::string & fName, char sep = ',', Mode mode = kMapped);
+	~CSVParser();
 
-	CSVParser operator++(void);
-	operator bool() const {return (*fIs) ? true : false;};
+	CSVParser & operator++(void);
+	operator bool() const {return fGood;};
 
 	int getColumn(const std::string & name);
+	int numColumns(void) const {return fColNames.size();};
+	bool isMapped(void) const {return fMap != 0;};
+	bool isCompressed(void) const {return fDecompress != 0;};
 
+	// Split the rows not yet read into (at most) n byte ranges [first, second) that begin and
+	// end on line boundaries.  Only for mapped files.
+	std::vector<std::pair<size_t, size_t> > splitRanges(int n) const;
+	// Restrict a mapped parser to the lines starting in [begin, end); then ++ to read the first.
+	bool setRange(size_t begin, size_t end);
+	// The offset of the line after the current one in a mapped file, e.g. to setRange() from later
+	size_t position(void) const {return (fPos < fMapLen) ? fPos : fMapLen;};
+	// The number of lines starting in [begin, end), two line boundaries of a mapped file
+	long countLines(size_t begin, size_t end) const;
+
+	// Malformed fields are reported (the first few of them) and counted; the value is then -1.
 	long getLong(int col) const;
 	double getDouble(int col) const;
+	long numBadFields(void) const {return fNumBadFields;};
+	bool readError(void) const {return fDecompress && fDecompress->failed();};  // the input was damaged
+	long lineNumber(void) const {return fLineNum;};
+	void reportBadField(int col, const char * type) const;
 
-	const std::string & operator[](int col) const {return fData[col];};
+	const CSVField & operator[](int col) const {return fData[col];};
 
 	void print(std::ostream & os) const;
 
 	protected :
 
 	char fSep;
-	std::ifstream *fIs;
+	std::istream *fIs;
+	DecompressStream *fDecompress;   // fIs, if the file is compressed
+	bool fOwnStream;
+	bool fGood;
 	std::map<std::string, int> fColNames;
-	std::vector<std::string> fData;
+	std::vector<CSVField> fData;
+	long fLineNum;
+	mutable long fNumBadFields;
+
+	std::string fLine;       // line buffer when reading from a stream
 
+	const char * fMap;       // whole file, when memory-mapped
+	size_t fMapLen;
+	size_t fPos;             // offset of the next line in fMap
+	size_t fEnd;             // stop at the first line starting at or after this offset
+
+	bool nextLine(const char * & line, size_t & len);
+	void split(const char * line, size_t len);
 	void parseHeader(void);
+
+	private :
+
+	CSVParser(const CSVParser &);              // fields point into this object's buffers
+	CSVParser & operator=(const CSVParser &);
 };
 
+// Decodes just the requested columns of each row into the members of a struct, e.g.
+//	struct Edge {long src; long dst; long dur;};
+//	CSVProjection<Edge> proj(netFS);
+//	proj.add("sourcePID", &Edge::src); proj.add("targetPID", &Edge::dst); proj.add("duration", &Edge::dur);
+//	Edge e;
+//	for ( ; netFS; ++netFS)
+//		if (proj.decode(e)) ...
+// decode() returns false if any requested field is malformed (and the parser reports it).
+
+template <typename Row>
+class CSVProjection {
+	public :
+
+	CSVProjection(CSVParser & parser) : fParser(parser) {};
+
+	bool add(const std::string & name, long Row::*member) {return add(fParser.getColumn(name), member, 0);};
+	bool add(const std::string & name, double Row::*member) {return add(fParser.getColumn(name), 0, member);};
+	// by column index, e.g. from another parser on the same file
+	bool add(int col, long Row::*member) {return add(col, member, 0);};
+	bool add(int col, double Row::*member) {return add(col, 0, member);};
+
+	bool decode(Row & row) const;
+
+	protected :
+
+	struct Column {
+		int col;
+		long Row::*longMember;
+		double Row::*doubleMember;
+	};
+
+	CSVParser & fParser;
+	std::vector<Column> fColumns;
+
+	bool add(int col, long Row::*lm, double Row::*dm);
+};
+
+template <typename Row>
+bool CSVProjection<Row>::add(int col, long Row::*lm, double Row::*dm)
+{
+	Column c;
+	c.col = col;
+	c.longMember = lm;
+	c.doubleMember = dm;
+	if (c.col < 0 || c.col >= fParser.numColumns())
+		return false;
+	fColumns.push_back(c);
+	return true;
+}
+
+template <typename Row>
+bool CSVProjection<Row>::decode(Row & row) const
+{
+	bool rtn = true;
+	for (size_t i = 0; i < fColumns.size(); i++)
+	{
+		const Column & c = fColumns[i];
+		bool ok = (c.longMember) ? fParser[c.col].toLong(row.*(c.longMember)) 
+		                         : fParser[c.col].toDouble(row.*(c.doubleMember));
+		if (! ok)
+		{
+			fParser.reportBadField(c.col, (c.longMember) ? "integer" : "number");
+			rtn = false;
+		}
+	}
+	return rtn;
+}
+
 #endif
@@ -0,0 +1,95 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H 1
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <stdint.h>
+
+#include "MatrixState.h"
+
+using namespace std;
+
+// How far a job has got through its network files, saved every so often so that a run that
+// is killed can pick up where it left off.  Each thread's piece of each network is recorded
+// separately, with the matrices it has accumulated so far; a resumed run reads the same
+// pieces, continuing each from its position, and so sums exactly the same contacts.
+//
+// The file is written atomically (see writeFileAtomically()), so it is always a complete
+// checkpoint, if not the latest.  It records each network file's size and modification
+// time and is only used if they haven't changed.
+//
+//	Checkpoint ckpt(outFile + ".ckpt", netFiles, 600);
+//	if (resume && ! ckpt.read()) ...
+//	... ckpt.update(piece); ckpt.writeIfDue(); ...
+//	ckpt.remove();
+
+class Checkpoint {
+	public :
+
+	struct Piece {
+		Piece(void) : network(0), index(0), begin(0), end(0), pos(0), added(0), unknown(0), bad(0), done(false) {};
+
+		uint32_t network;   // index in the job's network files
+		uint32_t index;     // of the piece in that file
+		uint64_t begin;     // a byte range of a CSV file, or a record range of an edge file;
+		uint64_t end;       // both 0 for a file that is read as a stream
+		uint64_t pos;       // where to continue: a byte or record, or for a stream, rows already read
+		int64_t added;      // the piece's NetworkTally so far
+		int64_t unknown;
+		int64_t bad;
+		bool done;
+		MatrixState contacts;
+	};
+
+	// Writes are at least interval seconds apart
+	Checkpoint(const string & fName, const vector<string> & netFiles, double interval);
+
+	const string & fileName(void) const {return fName;};
+
+	// Replaces the pieces with those in the file.  False, after a message to cerr, if it is
+	// damaged or was written for other network files.
+	bool read(void);
+	// The pieces of a network, in order; none if it hasn't been started
+	vector<Piece> pieces(uint32_t network) const;
+
+	// Records a piece's progress.  Thread-safe.
+	void update(const Piece & piece);
+	// Cheap enough to call every few thousand rows
+	bool due(void) const {return chrono::steady_clock::now().time_since_epoch().count() >= fNextWrite;};
+	// False, after a message to cerr, if the file couldn't be written
+	bool write(void);
+	bool writeIfDue(void);
+	void remove(void) const;
+
+	protected :
+
+	string fName;
+	vector<string> fNetFiles;
+	vector<int64_t> fSizes;
+	vector<int64_t> fMTimes;
+	chrono::steady_clock::duration fInterval;
+	atomic<int64_t> fNextWrite;   // steady_clock ticks
+
+	mutable mutex fMutex;
+	map<pair<uint32_t, uint32_t>, Piece> fPieces;   // by network and index
+
+	bool writeLocked(void);
+};
+
+#endif
@@ -75,16 +75,35 @@ class ContactConfig {
 	static string GetNetworkFile(void)       {return GetStringParam(fCCS.NetworkFileKey);};
 	static string GetPopFile(void) {return GetStringParam(fCCS.PopFileKey);};
 	static string GetOutputFile(void)  {return GetStringParam(fCCS.OutputFileKey);};
+	static string GetStatsFile(void)   {return GetStringParam(fCCS.StatsFileKey);};
+	static string GetBaseState(void)   {return GetStringParam(fCCS.BaseStateKey);};
+	static string GetAddedEdges(void)  {return GetStringParam(fCCS.AddedEdgesKey);};
+	static string GetRemovedEdges(void) {return GetStringParam(fCCS.RemovedEdgesKey);};
+	static string GetTempDirectory(void) {return GetStringParam(fCCS.TempDirectoryKey);};
 
 	// for parsing Person files
 	static string GetHHIdFieldName(void)     {return GetStringParam(fCCS.HHIdFieldNameKey);};
 	static string GetPersonIdFieldName(void) {return GetStringParam(fCCS.PersonIdFieldNameKey);};
 	static string GetAgeGroups(void)      {return GetStringParam(fCCS.AgeGroupKey);};
+	static string GetAgeSchemeFile(void)  {return GetStringParam(fCCS.AgeSchemeFileKey);};
 	static string GetAgeFieldName(void)      {return GetStringParam(fCCS.AgeFieldNameKey);};
 	static string GetGenderFieldName(void)   {return GetStringParam(fCCS.GenderFieldNameKey);};
 	static string GetGradeFieldName(void)   {return GetStringParam(fCCS.GradeFieldNameKey);};
 
 	static int GetVerbosity(void)           {return GetIntParam(fCCS.VerbosityKey);};
+	static int GetThreads(void)             {return GetIntParam(fCCS.ThreadsKey);};
+	static bool GetCombinedOutput(void)     {return GetIntParam(fCCS.CombinedOutputKey) != 0;};
+	static bool GetPopSnapshot(void)        {return GetIntParam(fCCS.PopSnapshotKey) != 0;};
+	static bool GetSaveState(void)          {return GetIntParam(fCCS.SaveStateKey) != 0;};
+	static int GetCheckpointInterval(void)  {return GetIntParam(fCCS.CheckpointIntervalKey);};
+	static bool GetResume(void)             {return GetIntParam(fCCS.ResumeKey) != 0;};
+	static int GetShard(void)               {return GetIntParam(fCCS.ShardKey);};
+	static int GetNumShards(void)           {return GetIntParam(fCCS.NumShardsKey);};
+	static int GetMemoryBudget(void)        {return GetIntParam(fCCS.MemoryBudgetKey);};
+	static bool GetByActivity(void)         {return GetIntParam(fCCS.ByActivityKey) != 0;};
+	static bool GetDistributions(void)      {return GetIntParam(fCCS.DistributionsKey) != 0;};
+	static int GetBootstrapReplicates(void) {return GetIntParam(fCCS.BootstrapReplicatesKey);};
+	static int GetBootstrapSeed(void)       {return GetIntParam(fCCS.BootstrapSeedKey);};
 	
 	static const vector<string> GetGroups(void) {return fGroups;};
 	static const vector<string> GetOrder(void) {return fOrder;};
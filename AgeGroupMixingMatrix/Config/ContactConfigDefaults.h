@@ -24,4 +24,30 @@ const string kDefNetworkFile = "";
 
 const string kDefAgeGroup = "CDC";
 
+const string kDefThreads = "1";
+
+const string kDefCombinedOutput = "0";
+
+const string kDefPopSnapshot = "1";
+
+const string kDefSaveState = "0";
+
+const string kDefCheckpointInterval = "0";
+
+const string kDefResume = "0";
+
+const string kDefNumShards = "1";
+
+const string kDefShard = "0";
+
+const string kDefMemoryBudget = "0";
+
+const string kDefByActivity = "0";
+
+const string kDefDistributions = "0";
+
+const string kDefBootstrapReplicates = "0";
+
+const string kDefBootstrapSeed = "1";
+
 #endif
@@ -37,6 +37,25 @@ class ContactConfigStrings
 		const string PopFileKey;
 		const string NetworkFileKey;
         	const string AgeGroupKey;
+		const string AgeSchemeFileKey;
+		const string ThreadsKey;
+		const string CombinedOutputKey;
+		const string PopSnapshotKey;
+		const string StatsFileKey;
+		const string SaveStateKey;
+		const string BaseStateKey;
+		const string AddedEdgesKey;
+		const string RemovedEdgesKey;
+		const string CheckpointIntervalKey;
+		const string ResumeKey;
+		const string ShardKey;
+		const string NumShardsKey;
+		const string MemoryBudgetKey;
+		const string TempDirectoryKey;
+		const string ByActivityKey;
+		const string DistributionsKey;
+		const string BootstrapReplicatesKey;
+		const string BootstrapSeedKey;
 
         	// for parsing Person files
         	const string HHIdFieldNameKey;
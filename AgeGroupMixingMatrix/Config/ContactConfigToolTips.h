@@ -22,8 +22,27 @@ const string kVerbosityToolTip = "Higher numbers produce more logging informatio
 const string kRandomSeedToolTip = "Initializes the random number generator";
 
 const string kPopFileToolTip = "File containing population with age and gender";
-const string kNetworkFileToolTip = "File containing contact network";
-const string kAgeGroupToolTip = "Whether to use CDC or PolyMod age groups";
+const string kNetworkFileToolTip = "File(s) containing contact networks: names or glob patterns separated by commas or semicolons";
+const string kAgeGroupToolTip = "Age group schemes to use, separated by blanks, commas or semicolons: CDC, PolyMod or ones defined in the age scheme file. With several, each writes its own output files, named with the scheme";
+const string kAgeSchemeFileToolTip = "File defining age group schemes, one per line: a name, then break-points and labels as age:label, e.g. school 0:preschool 5:school 18:adult 65:senior";
+const string kThreadsToolTip = "Number of threads reading the network (or population) file (0 means one per core)";
+const string kPopSnapshotToolTip = "1 caches the parsed population in a binary file next to the population file";
+const string kStatsFileToolTip = "If given, the time, throughput and memory of each phase of the run are written to this file, as JSON if its name ends in .json and CSV otherwise";
+const string kSaveStateToolTip = "1 also writes the exact counts behind each set of matrices to <output file>.state, so they can be updated later";
+const string kBaseStateToolTip = "Output file of an earlier run that saved its state: instead of reading network files, updates its matrices with the added and removed edges";
+const string kAddedEdgesToolTip = "With a base state, network file(s) holding the edges added since it was saved";
+const string kRemovedEdgesToolTip = "With a base state, network file(s) holding the edges removed since it was saved";
+const string kCheckpointIntervalToolTip = "Seconds between checkpoints of the progress through the network files, saved to <output file>.ckpt (0 means none)";
+const string kResumeToolTip = "1 continues from the checkpoint left by a run that was interrupted, if there is one";
+const string kNumShardsToolTip = "Number of processes the network files are divided among; with more than 1, each writes a partial result, <output file>.partial, to be summed by \"Contacts merge\"";
+const string kMemoryBudgetToolTip = "If not 0, megabytes of memory for an out-of-core run that sorts the population and networks by person id in temporary files and joins them, instead of holding the population in memory";
+const string kTempDirectoryToolTip = "Directory for the temporary files of a run with a memory budget (by default, the output file's)";
+const string kByActivityToolTip = "1 also writes matrices for each pair of source and target activities (0 to 15) in the networks, as <output file>-activity<src>_<dst>";
+const string kDistributionsToolTip = "1 also keeps a histogram of each matrix entry's contact durations and adds their quantiles and the share under 15 minutes to the output";
+const string kBootstrapReplicatesToolTip = "If not 0, number of Poisson bootstrap resamplings of the network rows, from which standard errors and 95% intervals of each matrix entry's count and duration are added to the output";
+const string kBootstrapSeedToolTip = "Seed of the bootstrap's random weights; the same seed gives the same output";
+const string kShardToolTip = "Which part of the network files this process reads, from 0 to one less than Shards";
+const string kCombinedOutputToolTip = "With several network files, 1 also writes matrices summed over all of them";
 
 const string kHHIdFieldToolTip = "Label (in header line) of column in csv file containing Household ID";
 const string kPersonIdFieldToolTip = "Label (in header line) of column in csv file containing Person ID in Person file";
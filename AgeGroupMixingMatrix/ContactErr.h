@@ -29,7 +29,10 @@ enum {
 
 	kBadPopFile,
 	kBadNetworkFile,
-	kUnimplemented
+	kUnimplemented,
+	kBadOutputFile,
+	kBadManifest,
+	kBadStateFile
 };
 
 const char * mystrerr(int errnum);
@@ -0,0 +1,152 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONTACT_JOB_H
+#define CONTACT_JOB_H 1
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "CSVParser.h"
+#include "ContactTensor.h"
+#include "PersonTable.h"
+#include "RunStats.h"
+#include "Checkpoint.h"
+
+using namespace std;
+
+// Which part of each network file a process reads: the index'th of count line-aligned byte
+// ranges (or, in an edge file, ranges of whole chunks).  A compressed file can't be split, so
+// it is read whole by one shard: the one numbered by its position in the list mod count.
+struct Shard {
+	Shard(int index = 0, int count = 1) : index(index), count(count) {};
+	bool all(void) const {return count <= 1;};
+	int index;
+	int count;
+};
+
+// Everything needed to produce one set of matrices: what a configuration file specifies
+// for a single run, or one line of a batch manifest.
+
+struct ContactJob {
+	ContactJob(void) : ageGroups("CDC"), numThreads(1), combined(false), useSnapshot(true), saveState(false),
+	                   checkpointInterval(0), resume(false), memoryBudget(0),
+	                   byActivity(false), distributions(false), bootstrapReplicates(0), bootstrapSeed(1) {};
+
+	string name;        // used to label log messages, e.g. a state abbreviation
+	string popFile;
+	vector<string> netFiles;  // none for contacts within households only
+	string outFile;     // prefix of the output file names
+	string ageGroups;   // scheme names separated by blanks, commas or semicolons: CDC, PolyMod
+	                    // or those defined in ageSchemeFile
+	string ageSchemeFile;  // see TableAgeGroups::readFile() in AgeGroups.h
+	int numThreads;     // for reading the network (or population) files; 0 means one per core
+	bool combined;      // with several networks, also write their sum
+	bool useSnapshot;   // read and write the population snapshot (see PopulationReader.h)
+	bool saveState;     // also write each set of matrices' MatrixState, to <prefix>.state
+
+	// Instead of reading networks, update the state saved with output file baseState
+	string baseState;
+	vector<string> addedFiles;    // edges that are new since then
+	vector<string> removedFiles;  // and those that are gone
+
+	// Reading networks, save progress to <outFile>.ckpt every so many seconds (0 for never)
+	double checkpointInterval;
+	bool resume;        // and start from the last checkpoint, if there is one
+
+	// Read just this part of the networks, and write a partial result instead of matrices
+	Shard shard;
+
+	// Instead of holding everyone in a PersonTable, sort the population and the edges by person
+	// id in about this many bytes of memory and join them, in one thread (0 for the usual way)
+	size_t memoryBudget;
+	string tempDir;     // for the sorted runs; by default, outFile's directory
+
+	// Also write matrices for each pair of source and target activities in the networks
+	bool byActivity;
+	// Also keep the distribution of each cell's contact durations, and write its quantiles
+	bool distributions;
+	// Also resample the rows of the networks this many times (see Bootstrap.h), and write each cell's
+	// standard errors and 95% intervals; none within households
+	int bootstrapReplicates;
+	uint64_t bootstrapSeed;
+};
+
+// Run a job from start to finish.  Returns 0 or one of the error codes in ContactErr.h.
+// The population is read once however many networks there are.  With one network the
+// matrices are written to outFile; with several, each network's go to outFile-<network>,
+// where <network> is the file name without its directory or extension, and their sum,
+// if requested, to outFile.
+// A sharded job writes <prefix>.partial in place of each set of matrices: a MatrixState with
+// the contacts in its part of the networks.  Only shard 0 includes the population sizes, so
+// the partials of all the shards add up to the whole (see mergePartials()).
+// A checkpoint is removed once the matrices have been written; resuming from one gives the
+// same output as a run that wasn't interrupted.
+// An update job reads <baseState>.state and the added and removed edge files instead, and
+// writes the updated matrices to outFile; it takes time in proportion to the number of edges
+// that changed (and the population).  Jobs saving state write it next to each set of matrices.
+// With several age group schemes, the job is run for each in turn, and outFile-<scheme> and
+// baseState-<scheme> take the place of outFile and baseState above.  Each scheme is dispatched
+// on once; everything after that is compiled for it.
+// The phases "population", "state" (for an update), "network", "merge" (summing the threads' and,
+// with combined output, the networks' matrices) and "output" are added to stats, if given, once
+// per scheme.
+int runJob(const ContactJob & job, RunStats * stats = 0);
+
+// Whether all of job.ageGroups are known, after reporting any that aren't
+bool checkAgeGroups(const ContactJob & job);
+
+// Sums the partial results (or saved states) in partials and writes the matrices to outFile.
+// They must all use the same age groups; those not built in must be defined in ageSchemeFile.
+// Returns 0 or one of the error codes in ContactErr.h.
+int mergePartials(const vector<string> & partials, const string & outFile, const string & ageSchemeFile = "");
+
+// The steps of a job, instantiated in ContactJob.C for each kind of scheme in AgeGroups.h.
+// The age groups are those of contacts.scheme().
+
+// Populates people and the population sizes in contacts
+template <class Scheme>
+bool readPopulation(const string & fName, PersonTable & people, ContactTensor<Scheme> & contacts,
+                    bool useSnapshot = true);
+
+// Populates contacts if there's no network file, reading pieces of the population in separate
+// threads.  A household's members must be in consecutive rows.
+template <class Scheme>
+bool readAtHomeNetwork(const string & fName, PersonTable & people, ContactTensor<Scheme> & contacts,
+                       bool useSnapshot = true, int numThreads = 1);
+
+// Adds the contacts in a network file, reading line-aligned pieces of the file in separate threads.
+// The contacts and bytes read are added to read's rows and bytes, and the time taken to sum
+// the pieces to merge's wall and cpu.  With a checkpoint, the pieces' progress is recorded
+// in it as the job's network'th file, and any progress already there is picked up.  Only the
+// shard's part of the file is read.
+template <class Scheme>
+bool aggregateNetwork(const string & netFile, int numThreads, const PersonTable & people, ContactTensor<Scheme> & contacts,
+                      PhaseStats * read = 0, PhaseStats * merge = 0, Checkpoint * checkpoint = 0, uint32_t network = 0,
+                      const Shard & shard = Shard());
+
+// Adds the contacts in each network file to the corresponding tensor, reading several
+// files at once when there are threads to spare
+template <class Scheme>
+bool aggregateNetworks(const vector<string> & netFiles, int numThreads, const PersonTable & people, 
+                       vector<ContactTensor<Scheme> > & contacts, PhaseStats * read = 0, PhaseStats * merge = 0,
+                       Checkpoint * checkpoint = 0, const Shard & shard = Shard());
+
+// Writes the state matrix and one matrix per county, adding the rows and bytes written to stats.
+// Contacts by activity are written the same way, for each pair of activities, with
+// "-activity<src>_<dst>" appended to outFName.
+template <class Scheme>
+bool writeMatrices(const string & outFName, const PersonTable & people, const ContactTensor<Scheme> & contacts,
+                   PhaseStats * stats = 0);
+
+#endif
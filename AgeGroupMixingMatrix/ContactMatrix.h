@@ -17,52 +17,228 @@
 #include <iostream>
 #include <vector>
 
+#include "AgeGroups.h"
+#include "FieldDecode.h"
+#include "DurationHistogram.h"
+#include "Bootstrap.h"
+
 using namespace std;
 
-// Need to setAgeGroup() before constructing any ContactMatirx objects!
+// N values of T: an array inside the object when N is a compile-time constant, or, when N is 0,
+// as many as the constructor is told on the heap
+template <class T, int N>
+struct GroupArray {
+	GroupArray(int) : v() {};
+	T & operator[](int i) {return v[i];};
+	const T & operator[](int i) const {return v[i];};
+	T v[N];
+};
+
+template <class T>
+struct GroupArray<T, 0> {
+	GroupArray(int n) : v(n) {};
+	T & operator[](int i) {return v[i];};
+	const T & operator[](int i) const {return v[i];};
+	vector<T> v;
+};
+
+// Contacts between the age groups of a Scheme (see AgeGroups.h), and the number of people
+// in each group.  For the built-in schemes the sizes are compile-time constants, so the counts
+// and durations are fixed arrays inside the object.  Each cell may also carry the distribution
+// of its contacts' durations (see DurationHistogram.h), and its counts and durations in each
+// bootstrap replicate (see Bootstrap.h), which add columns to the output.
+//
+//	ContactMatrix<CDCAgeGroups> cm;
+//	cm.addToCell(cm.cell(a, b), duration);
 
+template <class Scheme>
 class ContactMatrix {
 	public :
-	ContactMatrix(void) : fData(getNumGroups() * getNumGroups()), fPopSize(getNumGroups())
-		{for (int i=0; i<fData.size(); i++) {fData[i] = make_pair(0, 0.0);}};
 
-	void addPerson(const string & a)
-		{fPopSize[ageToIndex(a)]++;};
-	void addCount(const string & a, const string & b, long count = 0)
-		{fData[index(a,b)].first += count;};
+	// 0 if the scheme's size is only known at run time
+	enum {kNumGroups = Scheme::kNumGroups, kNumCells = kNumGroups * kNumGroups};
 
-	void addDuration(const string & a, const string & b, double dur = 86400.0)
-		{int idx = index(a,b); fData[idx].first++; fData[idx].second += dur;};
+	ContactMatrix(const Scheme & scheme = Scheme())
+		: fScheme(scheme), fCounts(numCells()), fDurations(numCells()), fPopSize(numGroups()), fNumReplicates(0) {};
 
-	long count(const string & a, const string & b) const {return fData[index(a,b)].first;};
-	long countAll(void) const
-		{int rtn=0; for (int i=0; i<fData.size(); i++) {rtn += fData[i].first;} return rtn;};
+	const Scheme & scheme(void) const {return fScheme;};
+	int numGroups(void) const {return (kNumGroups > 0) ? (int) kNumGroups : fScheme.numGroups();};
+	int numCells(void) const {return numGroups() * numGroups();};
 
-	double duration(const string & a, const string & b) const {return fData[index(a,b)].second;};
+	// Age groups a and b are indices returned by Scheme::ageToIndex().  Resolve them once per person,
+	// not once per contact.
+	void addPerson(int a, long n = 1) {fPopSize[a] += n;};
+	void addCount(int a, int b, long count) {fCounts[cell(a,b)] += count;};
+	void addDuration(int a, int b, double dur = 86400.0) {addToCell(cell(a,b), dur);};
 
-	void print(ostream & os) const;
+	// the same cell() is valid for every matrix of the scheme, so compute it once when updating several
+	int cell(int a, int b) const {return a * numGroups() + b;};
+	void addToCell(int idx, double dur) {fCounts[idx]++; fDurations[idx] += dur;};
+	// n contacts lasting totalDur altogether
+	void addToCell(int idx, long n, double totalDur) {fCounts[idx] += n; fDurations[idx] += totalDur;};
 
-	static void setAgeGroup(bool CDC = true) {fUseCDC = CDC;};
+	long count(int a, int b) const {return fCounts[cell(a,b)];};
+	double duration(int a, int b) const {return fDurations[cell(a,b)];};
+	long popSize(int a) const {return fPopSize[a];};
+	long countAll(void) const
+		{long rtn=0; for (int i=0; i<numCells(); i++) {rtn += fCounts[i];} return rtn;};
 
-	protected :
+	// the distribution of the durations of a cell's contacts: DurationHistogram::kNumBins counts,
+	// and the number shorter than DurationHistogram::kShortSeconds
+	void addDistribution(int idx, const long * bins, long numShort);
+	bool hasDistributions(void) const {return ! fBins.empty();};
+	// a cell's count and duration in each of numReplicates bootstrap replicates
+	void addReplicates(int idx, const long * counts, const double * durations, int numReplicates);
+	int numReplicates(void) const {return fNumReplicates;};
 
-	vector<pair<long, double> > fData;
-	vector<long> fPopSize;
+	ContactMatrix & operator+=(const ContactMatrix & cm);
 
-	string name(int ageGroup) const;
-	int ageToIndex(const string & a) const;
-	int index(const string & a, const string & b) const;
+	void print(ostream & os) const;
+	// appends what print() writes
+	void format(string & buf) const;
 
-	enum {kCDCUnknown=-1, kCDCPreschool, kCDCSchool, kCDCAdult, kCDCOlder, kCDCGolden, kCDCNumGroups};
-  // HSM: adjusted number of groups to incorporate 75-79 or 75+:
-  //	enum {kPOLYMODUnknown=-1, kPOLYMODNumGroups=15};
-  	enum {kPOLYMODUnknown=-1, kPOLYMODNumGroups=16};
-	static bool fUseCDC;  // hack alert: OK for two age group schemes, but unwieldy for more
+	protected :
 
-	static int getNumGroups(void) {return (fUseCDC) ? kCDCNumGroups : kPOLYMODNumGroups;};
+	Scheme fScheme;
+	GroupArray<long, kNumCells> fCounts;
+	GroupArray<double, kNumCells> fDurations;
+	GroupArray<long, kNumGroups> fPopSize;
+	vector<long> fBins;       // [cell][bin], empty without distributions
+	vector<long> fShort;      // [cell]
+	int fNumReplicates;
+	vector<long> fRepCounts;      // [cell][replicate], empty without a bootstrap
+	vector<double> fRepDurations;
 };
 
-inline ostream & operator<<(ostream & os, const ContactMatrix & cm)
+template <class Scheme>
+void ContactMatrix<Scheme>::addDistribution(int idx, const long * bins, long numShort)
+{
+	if (fBins.empty())
+	{
+		fBins.resize((size_t) numCells() * DurationHistogram::kNumBins, 0);
+		fShort.resize(numCells(), 0);
+	}
+	long * to = &fBins[(size_t) idx * DurationHistogram::kNumBins];
+	for (int b = 0; b < DurationHistogram::kNumBins; b++)
+		to[b] += bins[b];
+	fShort[idx] += numShort;
+}
+
+template <class Scheme>
+void ContactMatrix<Scheme>::addReplicates(int idx, const long * counts, const double * durations, int numReplicates)
+{
+	if (fRepCounts.empty())
+	{
+		fNumReplicates = numReplicates;
+		fRepCounts.resize((size_t) numCells() * numReplicates, 0);
+		fRepDurations.resize((size_t) numCells() * numReplicates, 0.0);
+	}
+	long * c = &fRepCounts[(size_t) idx * numReplicates];
+	double * d = &fRepDurations[(size_t) idx * numReplicates];
+	for (int r = 0; r < numReplicates; r++)
+	{
+		c[r] += counts[r];
+		d[r] += durations[r];
+	}
+}
+
+template <class Scheme>
+ContactMatrix<Scheme> & ContactMatrix<Scheme>::operator+=(const ContactMatrix & cm)
+{
+	for (int i=0; i<numCells(); i++)
+	{
+		fCounts[i] += cm.fCounts[i];
+		fDurations[i] += cm.fDurations[i];
+	}
+	for (int i=0; i<numGroups(); i++)
+		fPopSize[i] += cm.fPopSize[i];
+	for (int i=0; i<numCells() && cm.hasDistributions(); i++)
+		addDistribution(i, &cm.fBins[(size_t) i * DurationHistogram::kNumBins], cm.fShort[i]);
+	for (int i=0; i<numCells() && cm.fNumReplicates > 0; i++)
+		addReplicates(i, &cm.fRepCounts[(size_t) i * cm.fNumReplicates], &cm.fRepDurations[(size_t) i * cm.fNumReplicates],
+		              cm.fNumReplicates);
+	return *this;
+}
+
+template <class Scheme>
+void ContactMatrix<Scheme>::print(ostream & os) const
+{
+	string buf;
+	format(buf);
+	os.write(buf.data(), buf.size());
+}
+
+template <class Scheme>
+void ContactMatrix<Scheme>::format(string & buf) const
+{
+	const int numGroups = this->numGroups();
+	vector<string> names(numGroups);
+	for (int a = 0; a < numGroups; a++)
+		names[a] = string(fScheme.label(a)) + ',';
+
+	// quantiles are in days, like the total; empty for a cell without contacts
+	static const double kQuantiles[] = {0.1, 0.25, 0.5, 0.75, 0.9};
+	const int numQuantiles = sizeof(kQuantiles) / sizeof(kQuantiles[0]);
+	const bool dist = hasDistributions();
+	// bootstrap standard errors and 95% intervals
+	const double kLevel = 0.95;
+	const bool boot = fNumReplicates > 0;
+	vector<double> values(fNumReplicates);
+	buf.reserve(buf.size() + 64 + numGroups * numGroups * (48 + ((dist) ? 80 : 0) + ((boot) ? 96 : 0)));
+	buf += "src_age,dst_age,num_contacts,total_duration,num_people";
+	if (dist)
+		buf += ",p10_duration,p25_duration,median_duration,p75_duration,p90_duration,share_under_15min";
+	if (boot)
+		buf += ",num_contacts_se,num_contacts_lo95,num_contacts_hi95,total_duration_se,total_duration_lo95,total_duration_hi95";
+	buf += '\n';
+	char line[(10 + numQuantiles) * kMaxEncodedLength];
+	for (int a = 0; a < numGroups; a++)
+	{
+		for (int b = 0; b < numGroups; b++)
+		{
+			const int idx = cell(a, b);
+			buf += names[a];
+			buf += names[b];
+			char * p = encodeLong(fCounts[idx], line);
+			*p++ = ',';
+			p = encodeDouble(fDurations[idx] / 86400.0, p);
+			*p++ = ',';
+			p = encodeLong(fPopSize[a], p);
+			for (int q = 0; dist && q < numQuantiles; q++)
+			{
+				*p++ = ',';
+				if (fCounts[idx] > 0)
+					p = encodeDouble(DurationHistogram::quantile(&fBins[(size_t) idx * DurationHistogram::kNumBins], 
+					                                             kQuantiles[q]) / 86400.0, p);
+			}
+			if (dist)
+			{
+				*p++ = ',';
+				if (fCounts[idx] > 0)
+					p = encodeDouble((double) fShort[idx] / fCounts[idx], p);
+			}
+			for (int stat = 0; boot && stat < 2; stat++)
+			{
+				const size_t base = (size_t) idx * fNumReplicates;
+				for (int r = 0; r < fNumReplicates; r++)
+					values[r] = (stat == 0) ? fRepCounts[base + r] : fRepDurations[base + r] / 86400.0;
+				double se, lo, hi;
+				Bootstrap::summarize(values, kLevel, se, lo, hi);
+				*p++ = ',';
+				p = encodeDouble(se, p);
+				*p++ = ',';
+				p = encodeDouble(lo, p);
+				*p++ = ',';
+				p = encodeDouble(hi, p);
+			}
+			*p++ = '\n';
+			buf.append(line, p - line);
+		}
+	}
+}
+
+template <class Scheme>
+inline ostream & operator<<(ostream & os, const ContactMatrix<Scheme> & cm)
 { cm.print(os); return os; }
 
 #endif
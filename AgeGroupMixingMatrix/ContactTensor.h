@@ -0,0 +1,446 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONTACT_TENSOR_H
+#define CONTACT_TENSOR_H 1
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "ContactMatrix.h"
+#include "MatrixState.h"
+
+using namespace std;
+
+// The contact matrices of all the counties in a state, accumulated together.
+// Counts and durations are kept in separate contiguous arrays indexed by
+// [county][src age group][dst age group], and population sizes by [county][age group],
+// so adding a contact touches one element of each array.  Counties are the dense indices
+// handed out by PersonTable::internCounty().  The state matrix is the sum over counties.
+//
+// Like ContactMatrix, it is templated on the age group scheme, so for the built-in schemes
+// the stride between counties is a constant.
+//
+// Optionally, contacts are also accumulated by the pair of activities at their ends.  An
+// activity is a dense code, the network file's small integer, and a pair of them indexes
+// a set of county matrices of its own, allocated when the pair is first seen.  The
+// population sizes are shared.
+//
+// Also optionally, each cell of the totals keeps a histogram of its contacts' durations (see
+// DurationHistogram.h), in fixed memory however many contacts are added, and its counts and
+// durations in each replicate of a bootstrap (see Bootstrap.h).
+
+template <class Scheme>
+class ContactTensor {
+	public :
+
+	typedef ContactMatrix<Scheme> Matrix;
+	enum {kNumGroups = Matrix::kNumGroups, kCellsPerCounty = Matrix::kNumCells};   // 0 if not constant
+	// activities are 0 to kNumActivities - 1
+	enum {kNumActivities = 16, kNumActivityPairs = kNumActivities * kNumActivities};
+
+	ContactTensor(int numCounties = 0, const Scheme & scheme = Scheme(), bool byActivity = false,
+	              bool distributions = false, const Bootstrap & bootstrap = Bootstrap())
+		: fScheme(scheme), fNumCounties(0), fDistributions(distributions), fBootstrap(bootstrap)
+		{if (byActivity) fActivityPairs.resize(kNumActivityPairs); setNumCounties(numCounties);};
+
+	const Scheme & scheme(void) const {return fScheme;};
+	int numGroups(void) const {return (kNumGroups > 0) ? (int) kNumGroups : fScheme.numGroups();};
+	int cellsPerCounty(void) const {return numGroups() * numGroups();};
+
+	int numCounties(void) const {return fNumCounties;};
+	void setNumCounties(int n);  // existing counties keep their data
+
+	// the same as ContactMatrix::cell()
+	int cell(int a, int b) const {return a * numGroups() + b;};
+
+	void addPerson(int county, int a, long n = 1)
+		{fPopSize[(size_t) county * numGroups() + a] += n;};
+	void addContact(int county, int cell, double dur)
+	{
+		size_t i = (size_t) county * cellsPerCounty() + cell;
+		fCounts[i]++;
+		fDurations[i] += dur;
+		if (fDistributions)
+		{
+			fDurationBins[i * DurationHistogram::kNumBins + DurationHistogram::bin(dur)]++;
+			fShortCounts[i] += (dur < DurationHistogram::kShortSeconds);
+		}
+	};
+	// n contacts lasting totalDur altogether, which aren't counted in the distributions
+	void addContacts(int county, int cell, long n, double totalDur)
+		{size_t i = (size_t) county * cellsPerCounty() + cell; fCounts[i] += n; fDurations[i] += totalDur;};
+
+	bool hasDistributions(void) const {return fDistributions;};
+	const Bootstrap & bootstrap(void) const {return fBootstrap;};
+	// a contact already added with addContact(), weighted in each bootstrap replicate by the
+	// number of times the edge with this key (Bootstrap::edgeKey()) is drawn in it
+	void addReplicates(int county, int cell, double dur, uint64_t key)
+	{
+		uint8_t w[Bootstrap::kMaxReplicates];
+		fBootstrap.weights(key, w);
+		const int n = fBootstrap.numReplicates();
+		const size_t i = ((size_t) county * cellsPerCounty() + cell) * n;
+		long * counts = &fRepCounts[i];
+		double * durations = &fRepDurations[i];
+		for (int r = 0; r < n; r++)   // vectorized
+		{
+			counts[r] += w[r];
+			durations[r] += w[r] * dur;
+		}
+	};
+	bool byActivity(void) const {return ! fActivityPairs.empty();};
+	static bool isActivity(long activity) {return activity >= 0 && activity < kNumActivities;};
+	static int activityPair(long src, long dst) {return src * kNumActivities + dst;};
+	// a contact already added with addContact(), between people doing the pair of activities
+	void addActivityContact(int pair, int county, int cell, double dur)
+	{
+		Layer & l = fActivityPairs[pair];
+		if (l.counts.empty())
+			l.resize((size_t) fNumCounties * cellsPerCounty());
+		size_t i = (size_t) county * cellsPerCounty() + cell;
+		l.counts[i]++;
+		l.durations[i] += dur;
+	};
+
+	ContactTensor & operator+=(const ContactTensor & ct);
+	// just the counts and durations, e.g. to sum networks over the same population
+	void addContacts(const ContactTensor & ct);
+	// and to take away those of removed edges
+	void subtractContacts(const ContactTensor & ct);
+	// everything, where ct's county c is county counties[c] here
+	void addCounties(const ContactTensor & ct, const vector<int> & counties);
+
+	long population(void) const;   // people counted in all the counties
+	long popSize(int county, int a) const {return fPopSize[(size_t) county * numGroups() + a];};
+
+	// Everything, in state, with the counties named by countyNames
+	void save(MatrixState & state, const vector<string> & countyNames) const;
+	// Adds everything in state, where state's county c is county counties[c] here.
+	// False, after a message to cerr, if state has different age groups, or has
+	// distributions if this doesn't or vice versa, or another bootstrap.  Contacts by activity
+	// aren't saved.
+	bool restore(const MatrixState & state, const vector<int> & counties);
+
+	Matrix county(int c) const;
+	Matrix state(void) const;
+	// the same, for the contacts between people doing a pair of activities
+	bool hasActivityPair(int pair) const {return byActivity() && ! fActivityPairs[pair].counts.empty();};
+	Matrix county(int c, int pair) const;
+	Matrix state(int pair) const;
+
+	protected :
+
+	// the counts and durations of one pair of activities, like fCounts and fDurations;
+	// empty until the pair is seen
+	struct Layer {
+		vector<long> counts;
+		vector<double> durations;
+		void resize(size_t n) {counts.resize(n, 0); durations.resize(n, 0.0);};
+	};
+
+	Scheme fScheme;
+	int fNumCounties;
+
+	vector<long> fCounts;
+	vector<double> fDurations;
+	vector<long> fPopSize;
+	vector<Layer> fActivityPairs;   // empty unless by activity
+	bool fDistributions;
+	vector<long> fDurationBins;     // [county][src age group][dst age group][bin]
+	vector<long> fShortCounts;      // [county][src age group][dst age group]
+	Bootstrap fBootstrap;
+	vector<long> fRepCounts;        // [county][src age group][dst age group][replicate]
+	vector<double> fRepDurations;
+
+	void addCounty(int c, const long * counts, const double * durations, Matrix & cm) const;
+	void addActivityPairs(const ContactTensor & ct, long sign);
+	void addDistributions(const ContactTensor & ct, long sign);
+	void addReplicates(const ContactTensor & ct, long sign);
+};
+
+template <class Scheme>
+void ContactTensor<Scheme>::setNumCounties(int n)
+{
+	// county-major layout, so adding counties at the end doesn't move anything
+	fNumCounties = n;
+	fCounts.resize((size_t) n * cellsPerCounty(), 0);
+	fDurations.resize((size_t) n * cellsPerCounty(), 0.0);
+	fPopSize.resize((size_t) n * numGroups(), 0);
+	if (fDistributions)
+	{
+		fDurationBins.resize((size_t) n * cellsPerCounty() * DurationHistogram::kNumBins, 0);
+		fShortCounts.resize((size_t) n * cellsPerCounty(), 0);
+	}
+	fRepCounts.resize((size_t) n * cellsPerCounty() * fBootstrap.numReplicates(), 0);
+	fRepDurations.resize((size_t) n * cellsPerCounty() * fBootstrap.numReplicates(), 0.0);
+	for (size_t p = 0; p < fActivityPairs.size(); p++)
+		if (! fActivityPairs[p].counts.empty())
+			fActivityPairs[p].resize((size_t) n * cellsPerCounty());
+}
+
+template <class Scheme>
+ContactTensor<Scheme> & ContactTensor<Scheme>::operator+=(const ContactTensor & ct)
+{
+	addContacts(ct);
+	for (size_t i = 0; i < ct.fPopSize.size(); i++)
+		fPopSize[i] += ct.fPopSize[i];
+	return *this;
+}
+
+template <class Scheme>
+void ContactTensor<Scheme>::addContacts(const ContactTensor & ct)
+{
+	if (ct.fNumCounties > fNumCounties)
+		setNumCounties(ct.fNumCounties);
+	for (size_t i = 0; i < ct.fCounts.size(); i++)
+	{
+		fCounts[i] += ct.fCounts[i];
+		fDurations[i] += ct.fDurations[i];
+	}
+	addActivityPairs(ct, 1);
+	addDistributions(ct, 1);
+	addReplicates(ct, 1);
+}
+
+template <class Scheme>
+void ContactTensor<Scheme>::addCounties(const ContactTensor & ct, const vector<int> & counties)
+{
+	for (int c = 0; c < ct.fNumCounties; c++)
+	{
+		const int to = counties[c];
+		if (to >= fNumCounties)
+			setNumCounties(to + 1);
+		const size_t from = (size_t) c * cellsPerCounty();
+		const size_t base = (size_t) to * cellsPerCounty();
+		for (int i = 0; i < cellsPerCounty(); i++)
+		{
+			fCounts[base + i] += ct.fCounts[from + i];
+			fDurations[base + i] += ct.fDurations[from + i];
+		}
+		for (int a = 0; a < numGroups(); a++)
+			fPopSize[(size_t) to * numGroups() + a] += ct.fPopSize[(size_t) c * numGroups() + a];
+		for (int i = 0; fDistributions && ct.fDistributions && i < cellsPerCounty(); i++)
+		{
+			fShortCounts[base + i] += ct.fShortCounts[from + i];
+			for (int b = 0; b < DurationHistogram::kNumBins; b++)
+				fDurationBins[(base + i) * DurationHistogram::kNumBins + b] 
+					+= ct.fDurationBins[(from + i) * DurationHistogram::kNumBins + b];
+		}
+		const size_t numReps = (size_t) cellsPerCounty() * fBootstrap.numReplicates();
+		for (size_t r = 0; ct.fBootstrap.numReplicates() == fBootstrap.numReplicates() && r < numReps; r++)
+		{
+			fRepCounts[base * fBootstrap.numReplicates() + r] += ct.fRepCounts[from * fBootstrap.numReplicates() + r];
+			fRepDurations[base * fBootstrap.numReplicates() + r] += ct.fRepDurations[from * fBootstrap.numReplicates() + r];
+		}
+	}
+}
+
+template <class Scheme>
+void ContactTensor<Scheme>::subtractContacts(const ContactTensor & ct)
+{
+	if (ct.fNumCounties > fNumCounties)
+		setNumCounties(ct.fNumCounties);
+	for (size_t i = 0; i < ct.fCounts.size(); i++)
+	{
+		fCounts[i] -= ct.fCounts[i];
+		fDurations[i] -= ct.fDurations[i];
+	}
+	addActivityPairs(ct, -1);
+	addDistributions(ct, -1);
+	addReplicates(ct, -1);
+}
+
+// ct has no more counties than this; both must have distributions, or neither
+template <class Scheme>
+void ContactTensor<Scheme>::addDistributions(const ContactTensor & ct, long sign)
+{
+	if (! fDistributions || ! ct.fDistributions)
+		return;
+	for (size_t i = 0; i < ct.fDurationBins.size(); i++)
+		fDurationBins[i] += sign * ct.fDurationBins[i];
+	for (size_t i = 0; i < ct.fShortCounts.size(); i++)
+		fShortCounts[i] += sign * ct.fShortCounts[i];
+}
+
+// ct has no more counties than this, and the same bootstrap
+template <class Scheme>
+void ContactTensor<Scheme>::addReplicates(const ContactTensor & ct, long sign)
+{
+	for (size_t i = 0; i < ct.fRepCounts.size(); i++)
+	{
+		fRepCounts[i] += sign * ct.fRepCounts[i];
+		fRepDurations[i] += sign * ct.fRepDurations[i];
+	}
+}
+
+// ct has no more counties than this
+template <class Scheme>
+void ContactTensor<Scheme>::addActivityPairs(const ContactTensor & ct, long sign)
+{
+	if (ct.fActivityPairs.empty())
+		return;
+	fActivityPairs.resize(kNumActivityPairs);
+	for (int p = 0; p < kNumActivityPairs; p++)
+	{
+		const Layer & from = ct.fActivityPairs[p];
+		if (from.counts.empty())
+			continue;
+		Layer & to = fActivityPairs[p];
+		if (to.counts.empty())
+			to.resize((size_t) fNumCounties * cellsPerCounty());
+		for (size_t i = 0; i < from.counts.size(); i++)
+		{
+			to.counts[i] += sign * from.counts[i];
+			to.durations[i] += sign * from.durations[i];
+		}
+	}
+}
+
+template <class Scheme>
+void ContactTensor<Scheme>::save(MatrixState & state, const vector<string> & countyNames) const
+{
+	state.scheme = fScheme.name();
+	state.schemeChecksum = fScheme.checksum();
+	state.numGroups = numGroups();
+	state.counties.assign(countyNames.begin(), countyNames.begin() + fNumCounties);
+	state.counts.assign(fCounts.begin(), fCounts.end());
+	state.durations.assign(fDurations.begin(), fDurations.end());
+	state.popSize.assign(fPopSize.begin(), fPopSize.end());
+	state.durationBins.assign(fDurationBins.begin(), fDurationBins.end());
+	state.shortCounts.assign(fShortCounts.begin(), fShortCounts.end());
+	state.numReplicates = fBootstrap.numReplicates();
+	state.bootstrapSeed = fBootstrap.seed();
+	state.repCounts.assign(fRepCounts.begin(), fRepCounts.end());
+	state.repDurations.assign(fRepDurations.begin(), fRepDurations.end());
+}
+
+template <class Scheme>
+bool ContactTensor<Scheme>::restore(const MatrixState & state, const vector<int> & counties)
+{
+	if (state.scheme != fScheme.name() || state.schemeChecksum != fScheme.checksum()
+	    || state.numGroups != numGroups())
+	{
+		cerr << "Matrix state has age groups '" << state.scheme << "', not '" << fScheme.name() << "'" << endl;
+		return false;
+	}
+	if (state.hasDistributions() != fDistributions)
+	{
+		cerr << "Matrix state has " << ((fDistributions) ? "no " : "") << "duration distributions" << endl;
+		return false;
+	}
+	if (state.numReplicates != (uint32_t) fBootstrap.numReplicates() 
+	    || (state.numReplicates > 0 && state.bootstrapSeed != fBootstrap.seed()))
+	{
+		cerr << "Matrix state has " << state.numReplicates << " bootstrap replicates with seed " << state.bootstrapSeed
+		     << ", not " << fBootstrap.numReplicates() << " with seed " << fBootstrap.seed() << endl;
+		return false;
+	}
+	for (size_t c = 0; c < state.counties.size(); c++)
+	{
+		const int to = counties[c];
+		if (to >= fNumCounties)
+			setNumCounties(to + 1);
+		const size_t from = c * cellsPerCounty();
+		const size_t base = (size_t) to * cellsPerCounty();
+		for (int i = 0; i < cellsPerCounty(); i++)
+		{
+			fCounts[base + i] += state.counts[from + i];
+			fDurations[base + i] += state.durations[from + i];
+		}
+		for (int a = 0; a < numGroups(); a++)
+			fPopSize[(size_t) to * numGroups() + a] += state.popSize[c * numGroups() + a];
+		for (int i = 0; fDistributions && i < cellsPerCounty(); i++)
+		{
+			fShortCounts[base + i] += state.shortCounts[from + i];
+			for (int b = 0; b < DurationHistogram::kNumBins; b++)
+				fDurationBins[(base + i) * DurationHistogram::kNumBins + b] 
+					+= state.durationBins[(from + i) * DurationHistogram::kNumBins + b];
+		}
+		const size_t numReps = (size_t) cellsPerCounty() * state.numReplicates;
+		for (size_t r = 0; r < numReps; r++)
+		{
+			fRepCounts[base * state.numReplicates + r] += state.repCounts[from * state.numReplicates + r];
+			fRepDurations[base * state.numReplicates + r] += state.repDurations[from * state.numReplicates + r];
+		}
+	}
+	return true;
+}
+
+template <class Scheme>
+long ContactTensor<Scheme>::population(void) const
+{
+	long rtn = 0;
+	for (size_t i = 0; i < fPopSize.size(); i++)
+		rtn += fPopSize[i];
+	return rtn;
+}
+
+template <class Scheme>
+void ContactTensor<Scheme>::addCounty(int c, const long * counts, const double * durations, Matrix & cm) const
+{
+	size_t base = (size_t) c * cellsPerCounty();
+	for (int i = 0; i < cellsPerCounty(); i++)
+		cm.addToCell(i, counts[base + i], durations[base + i]);
+	base = (size_t) c * numGroups();
+	for (int a = 0; a < numGroups(); a++)
+		cm.addPerson(a, fPopSize[base + a]);
+}
+
+template <class Scheme>
+typename ContactTensor<Scheme>::Matrix ContactTensor<Scheme>::county(int c) const
+{
+	Matrix rtn(fScheme);
+	addCounty(c, fCounts.data(), fDurations.data(), rtn);
+	const size_t base = (size_t) c * cellsPerCounty();
+	for (int i = 0; fDistributions && i < cellsPerCounty(); i++)
+		rtn.addDistribution(i, &fDurationBins[(base + i) * DurationHistogram::kNumBins], fShortCounts[base + i]);
+	const int n = fBootstrap.numReplicates();
+	for (int i = 0; n > 0 && i < cellsPerCounty(); i++)
+		rtn.addReplicates(i, &fRepCounts[(base + i) * n], &fRepDurations[(base + i) * n], n);
+	return rtn;
+}
+
+template <class Scheme>
+typename ContactTensor<Scheme>::Matrix ContactTensor<Scheme>::state(void) const
+{
+	Matrix rtn(fScheme);
+	for (int c = 0; c < fNumCounties; c++)
+		addCounty(c, fCounts.data(), fDurations.data(), rtn);
+	for (size_t i = 0; i < fShortCounts.size(); i++)
+		rtn.addDistribution(i % cellsPerCounty(), &fDurationBins[i * DurationHistogram::kNumBins], fShortCounts[i]);
+	const int n = fBootstrap.numReplicates();
+	for (size_t i = 0; n > 0 && i < (size_t) fNumCounties * cellsPerCounty(); i++)
+		rtn.addReplicates(i % cellsPerCounty(), &fRepCounts[i * n], &fRepDurations[i * n], n);
+	return rtn;
+}
+
+template <class Scheme>
+typename ContactTensor<Scheme>::Matrix ContactTensor<Scheme>::county(int c, int pair) const
+{
+	Matrix rtn(fScheme);
+	const Layer & l = fActivityPairs[pair];
+	addCounty(c, l.counts.data(), l.durations.data(), rtn);
+	return rtn;
+}
+
+template <class Scheme>
+typename ContactTensor<Scheme>::Matrix ContactTensor<Scheme>::state(int pair) const
+{
+	Matrix rtn(fScheme);
+	const Layer & l = fActivityPairs[pair];
+	for (int c = 0; c < fNumCounties; c++)
+		addCounty(c, l.counts.data(), l.durations.data(), rtn);
+	return rtn;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H 1
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <istream>
+#include <streambuf>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Reading gzip and zstd files as if they weren't compressed.
+//
+// The compressed file is memory-mapped and a background thread decompresses it into a
+// short queue of blocks, so decompression overlaps with whatever the reader does with the
+// text.  When the format says where its independent pieces start, several of them are
+// decompressed at once: the members of a BGZF file (bgzip), or the frames of a multi-frame
+// zstd file (pzstd, zstd --block-size).  Other gzip files, including concatenated ones,
+// are decompressed by the one background thread.
+//
+// zstd support needs the library: build with "make ZSTD=1".
+
+enum Compression {kNoCompression, kGzip, kZstd};
+
+// from the first bytes of the file
+Compression detectCompression(const std::string & fName);
+const char * compressionName(Compression c);
+
+class DecompressBuf : public std::streambuf {
+	public :
+
+	// numThreads = 0 means one per core
+	DecompressBuf(const std::string & fName, int numThreads = 0);
+	~DecompressBuf();
+
+	bool isOpen(void) const {return fMap != 0;};
+	bool failed(void) const;   // the input was damaged or truncated
+
+	protected :
+
+	virtual int_type underflow(void);
+
+	std::string fName;
+	Compression fType;
+	int fNumThreads;
+	const unsigned char * fMap;
+	size_t fMapLen;
+
+	std::thread fProducer;
+	mutable std::mutex fMutex;
+	std::condition_variable fCanPush;
+	std::condition_variable fCanPop;
+	std::deque<std::vector<char> > fQueue;
+	std::vector<char> fCurrent;   // being read
+	bool fDone;
+	bool fFailed;
+	bool fStop;                   // the reader has gone away
+
+	void produce(void);
+	size_t produceGzip(size_t pos);
+	size_t produceBGZF(size_t pos);
+	size_t produceZstd(size_t pos);
+	bool push(std::vector<char> & block);
+	void fail(const std::string & why);
+
+	private :
+
+	DecompressBuf(const DecompressBuf &);
+	DecompressBuf & operator=(const DecompressBuf &);
+};
+
+class DecompressStream : public std::istream {
+	public :
+
+	DecompressStream(const std::string & fName, int numThreads = 0);
+
+	bool failed(void) const {return fBuf.failed();};
+
+	protected :
+
+	DecompressBuf fBuf;
+};
+
+#endif
@@ -0,0 +1,78 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DURATION_HISTOGRAM_H
+#define DURATION_HISTOGRAM_H 1
+
+#include <stdint.h>
+
+// The distribution of contact durations, in seconds, as counts in a fixed number of log-linear
+// bins: one per second below kSubBins seconds, then kSubBins equal bins in each doubling, up to
+// kMaxSeconds.  So a bin is never more than 1/kSubBins of its lower bound wide, and histograms
+// are merged exactly by adding their counts.  Longer durations go in the last bin.
+//
+// Durations under kShortSeconds (15 minutes) are counted separately, exactly, since that
+// isn't a bin boundary.
+//
+//	long bins[DurationHistogram::kNumBins] = {};
+//	bins[DurationHistogram::bin(dur)]++;
+//	double median = DurationHistogram::quantile(bins, 0.5);
+
+struct DurationHistogram {
+	enum {kSubBits = 3, kSubBins = 1 << kSubBits, kMaxBits = 17, kMaxSeconds = 1 << kMaxBits,
+	      kNumBins = kSubBins * (kMaxBits - kSubBits + 1), kShortSeconds = 15 * 60};
+
+	static int bin(double seconds)
+	{
+		if (seconds < kSubBins)
+			return (seconds > 0) ? (int) seconds : 0;
+		if (seconds >= kMaxSeconds)
+			return kNumBins - 1;
+		const uint64_t s = (uint64_t) seconds;
+		const int e = 63 - __builtin_clzll(s);   // at least kSubBits
+		return kSubBins * (e - kSubBits + 1) + (int) ((s >> (e - kSubBits)) & (kSubBins - 1));
+	};
+	// the whole seconds in bin b are [lower(b), upper(b))
+	static double lower(int b)
+	{
+		if (b < kSubBins)
+			return b;
+		const int shift = b / kSubBins - 1;
+		return (double) ((uint64_t) (kSubBins + b % kSubBins) << shift);
+	};
+	static double upper(int b) {return (b < kSubBins) ? b + 1 : lower(b) + (double) ((uint64_t) 1 << (b / kSubBins - 1));};
+
+	// The q'th quantile, 0 <= q <= 1, of the durations counted in bins, interpolating within
+	// a bin; -1 if there are none
+	static double quantile(const long * bins, double q)
+	{
+		long n = 0;
+		for (int b = 0; b < kNumBins; b++)
+			n += bins[b];
+		if (n == 0)
+			return -1;
+		const double rank = q * n;
+		long before = 0;
+		for (int b = 0; b < kNumBins; b++)
+		{
+			if (bins[b] > 0 && before + bins[b] >= rank)
+			{
+				const double f = (rank - before) / bins[b];
+				return lower(b) + f * (upper(b) - lower(b) - 1);
+			}
+			before += bins[b];
+		}
+		return lower(kNumBins - 1);
+	};
+};
+
+#endif
@@ -0,0 +1,138 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EDGE_FILE_H
+#define EDGE_FILE_H 1
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <string.h>
+#include <stdint.h>
+
+using namespace std;
+
+// A contact network in a packed binary format, so it can be read without parsing text.
+//
+// The file is a fixed header followed by fixed-width, native-endian records.  A record
+// holds some subset of the network file's columns, in this order: person ids are 8 bytes,
+// activities and durations 4.  The records are grouped into chunks of a fixed number of
+// records, the unit in which a file is divided among threads.
+//
+// Convert a CSV network once with "Contacts convert"; any "Network File" may then name the
+// result, which is recognized by its first bytes rather than by its name.
+
+class EdgeFile {
+	public :
+
+	// the columns of a network file
+	enum Column {kTargetPID, kTargetActivity, kSourcePID, kSourceActivity, kDuration, kNumColumns};
+	static const char * columnName(int c);
+	static int columnIndex(const string & name);  // -1 if it isn't one of the above
+
+	EdgeFile(void);
+	~EdgeFile();
+
+	bool open(const string & fName);   // false, after a message, if it isn't a readable edge file
+	static bool isEdgeFile(const string & fName);
+
+	uint64_t numRecords(void) const {return fNumRecords;};
+	bool hasColumn(int c) const {return fOffset[c] >= 0;};
+	long get(uint64_t record, int c) const;
+
+	// Split the records into at most n ranges [first, second) of whole chunks
+	vector<pair<uint64_t, uint64_t> > splitChunks(int n) const {return splitChunks(n, make_pair((uint64_t) 0, fNumRecords));};
+	// the same for just the records in range, which starts on a chunk boundary
+	vector<pair<uint64_t, uint64_t> > splitChunks(int n, pair<uint64_t, uint64_t> range) const;
+
+	// Convert a CSV network file, keeping the named columns; rows with malformed fields are
+	// skipped and counted.  Returns false, after a message, if it can't be done.
+	static bool convert(const string & csvName, const string & edgeName, const vector<string> & columns,
+	                    uint64_t chunkRecords = kDefChunkRecords);
+
+	static const uint64_t kDefChunkRecords = 1 << 20;
+
+	protected :
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t recordSize;
+		uint32_t columns;       // bit c is set if column c is present
+		uint32_t pad;
+		uint64_t numRecords;
+		uint64_t chunkRecords;
+		uint64_t dataOffset;    // of the first record
+	};
+
+	const char * fMap;
+	size_t fMapLen;
+	const char * fData;
+	uint64_t fNumRecords;
+	uint64_t fChunkRecords;
+	uint32_t fRecordSize;
+	int fOffset[kNumColumns];   // within a record; -1 if absent
+	int fWidth[kNumColumns];
+
+	static uint32_t layout(uint32_t columns, int * offset, int * width);
+
+	friend class EdgeWriter;
+
+	private :
+
+	EdgeFile(const EdgeFile &);
+	EdgeFile & operator=(const EdgeFile &);
+};
+
+inline long EdgeFile::get(uint64_t record, int c) const
+{
+	const char * p = fData + record * fRecordSize + fOffset[c];
+	if (fWidth[c] == 8)
+	{
+		int64_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+	int32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Writes an edge file one record at a time
+class EdgeWriter {
+	public :
+
+	EdgeWriter(void) : fColumns(0), fRecordSize(0), fNumRecords(0), fChunkRecords(0) {};
+
+	bool open(const string & fName, uint32_t columns, uint64_t chunkRecords = EdgeFile::kDefChunkRecords);
+	// vals is indexed by EdgeFile::Column; false if a value doesn't fit its column
+	bool add(const long * vals);
+	bool close(void);   // writes the header
+	void abandon(void); // removes what has been written
+
+	uint64_t numRecords(void) const {return fNumRecords;};
+
+	protected :
+
+	string fName;
+	ofstream fOs;
+	uint32_t fColumns;
+	uint32_t fRecordSize;
+	uint64_t fNumRecords;
+	uint64_t fChunkRecords;
+	int fOffset[EdgeFile::kNumColumns];
+	int fWidth[EdgeFile::kNumColumns];
+	vector<char> fBuf;
+};
+
+#endif
@@ -0,0 +1,313 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H 1
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Sorts more fixed-size records than fit in memory.  Records are added to a buffer of at most
+// memoryBytes; each time it fills, it is sorted and written to a run file in tempDir.  Then
+// next() returns all the records in order, merging the runs, each read through a share of
+// the same memory.  With more than kMaxFanIn runs, finish() first merges groups of them into
+// longer runs, as many times as it takes, so that neither the open files nor the number of
+// reads grows with the number of runs.  If the records never filled the buffer, nothing is
+// written.  Records that compare equal come out in the order they were added.  The run files
+// are removed as soon as they have been read, or when the sorter is deleted.
+//
+//	ExternalSorter<Edge, BySource> edges(tempDir, 1 << 30, "edges");
+//	for (...) edges.add(e);
+//	if (! edges.finish()) ...
+//	while (edges.next(e)) ...
+//	if (edges.failed()) ...
+//
+// Record must be trivially copyable; Less is a strict weak ordering of Records.
+
+// A name in dir that no other file, in this or another process, is using
+inline string tempFileName(const string & dir, const string & label)
+{
+	static atomic<int> counter(0);   // shared by every kind of record
+	return ((dir.empty()) ? string(".") : dir) + "/" + label + "." + to_string(getpid())
+	       + "." + to_string(counter++) + ".tmp";
+}
+
+// A file of records, written and then read back in blocks
+template <class Record>
+class RecordFile {
+	public :
+
+	RecordFile(const string & fName) : fName(fName), fNext(0), fEnd(0) {};
+	~RecordFile() {remove();};
+
+	const string & name(void) const {return fName;};
+	bool write(const Record * r, size_t n)
+	{
+		if (! fOut.is_open())
+			fOut.open(fName.c_str(), ios::binary | ios::trunc);
+		fOut.write((const char *) r, n * sizeof(Record));
+		return (bool) fOut;
+	};
+	// when it's all written, so that waiting runs don't hold files open
+	bool close(void)
+	{
+		fOut.close();
+		return ! fOut.fail();
+	};
+	// through a buffer of bufRecords
+	bool openForReading(size_t bufRecords)
+	{
+		const bool ok = ! fOut.is_open() || close();
+		fIn.close();
+		fIn.clear();
+		fIn.open(fName.c_str(), ios::binary);
+		fBuf.resize(max(bufRecords, (size_t) 1));
+		fNext = fEnd = 0;
+		return ok && (bool) fIn;
+	};
+	// false at the end, or if it couldn't be read (see failed())
+	bool next(Record & r)
+	{
+		if (fNext == fEnd)
+		{
+			fIn.read((char *) fBuf.data(), fBuf.size() * sizeof(Record));
+			fEnd = fIn.gcount() / sizeof(Record);
+			fNext = 0;
+			if (fEnd == 0)
+				return false;
+		}
+		r = fBuf[fNext++];
+		return true;
+	};
+	bool failed(void) const {return fIn.bad();};
+	void remove(void) {fOut.close(); fIn.close(); ::unlink(fName.c_str()); vector<Record>().swap(fBuf);};
+
+	static string tempName(const string & dir, const string & label) {return tempFileName(dir, label);};
+
+	protected :
+
+	string fName;
+	ofstream fOut;
+	ifstream fIn;
+	vector<Record> fBuf;
+	size_t fNext;
+	size_t fEnd;
+};
+
+template <class Record, class Less>
+class ExternalSorter {
+	public :
+
+	ExternalSorter(const string & tempDir, size_t memoryBytes, const string & label, Less less = Less())
+		: fTempDir(tempDir), fLabel(label), fLess(less), fFailed(false), fNext(0), fNumRuns(0), fHeads(HeadOrder(less))
+		{fCapacity = max(memoryBytes / sizeof(Record), (size_t) 1024);};
+	~ExternalSorter() {for (size_t i = 0; i < fRuns.size(); i++) delete fRuns[i];};
+
+	void add(const Record & r)
+	{
+		if (fBuf.size() >= fCapacity)
+			spill();
+		if (fBuf.size() == fBuf.capacity())   // grow no further than the budget
+			fBuf.reserve(min(fCapacity, max(2 * fBuf.size(), (size_t) 4096)));
+		fBuf.push_back(r);
+	};
+	// false, after a message to cerr, if a run couldn't be written or read back
+	bool finish(void);
+	bool next(Record & r);
+	bool failed(void) const {return fFailed;};
+	size_t numRuns(void) const {return fNumRuns;};   // sorted and written, before any merging
+
+	// runs merged at once
+	static const size_t kMaxFanIn = 64;
+
+	protected :
+
+	// the next record of each run, the earliest on top; ties go to the earlier run
+	typedef pair<Record, size_t> Head;
+	struct HeadOrder {
+		HeadOrder(const Less & less) : less(less) {};
+		bool operator()(const Head & a, const Head & b) const
+			{return less(b.first, a.first) || (! less(a.first, b.first) && b.second < a.second);};
+		Less less;
+	};
+
+	string fTempDir;
+	string fLabel;
+	Less fLess;
+	size_t fCapacity;     // records in memory
+	bool fFailed;
+	vector<Record> fBuf;
+	size_t fNext;         // in fBuf, when nothing was spilled
+	size_t fNumRuns;
+	vector<RecordFile<Record> *> fRuns;
+	priority_queue<Head, vector<Head>, HeadOrder> fHeads;
+
+	void spill(void);
+	bool openRuns(size_t begin, size_t end, size_t bufRecords, priority_queue<Head, vector<Head>, HeadOrder> & heads);
+	bool mergeRuns(size_t begin, size_t end, vector<RecordFile<Record> *> & merged);
+	bool readFailed(RecordFile<Record> * run);
+};
+
+template <class Record, class Less>
+void ExternalSorter<Record, Less>::spill(void)
+{
+	stable_sort(fBuf.begin(), fBuf.end(), fLess);
+	RecordFile<Record> * run = new RecordFile<Record>(RecordFile<Record>::tempName(fTempDir, fLabel));
+	fRuns.push_back(run);
+	fNumRuns++;
+	if (! fFailed && ! (run->write(fBuf.data(), fBuf.size()) && run->close()))
+	{
+		cerr << "Couldn't write temporary file '" << run->name() << "'" << endl;
+		fFailed = true;
+	}
+	fBuf.clear();
+}
+
+template <class Record, class Less>
+bool ExternalSorter<Record, Less>::finish(void)
+{
+	if (fRuns.empty())
+	{
+		stable_sort(fBuf.begin(), fBuf.end(), fLess);
+		fNext = 0;
+		return true;
+	}
+	if (! fBuf.empty())
+		spill();
+	vector<Record>().swap(fBuf);
+	if (fFailed)
+		return false;
+
+	while (fRuns.size() > kMaxFanIn)
+	{
+		vector<RecordFile<Record> *> merged;
+		bool ok = true;
+		for (size_t i = 0; ok && i < fRuns.size(); i += kMaxFanIn)
+			ok = mergeRuns(i, min(i + kMaxFanIn, fRuns.size()), merged);
+		for (size_t i = 0; i < fRuns.size(); i++)
+			delete fRuns[i];
+		fRuns.swap(merged);
+		if (! ok)
+			return false;
+	}
+	// each run is read through an equal share of the memory
+	return openRuns(0, fRuns.size(), fCapacity / fRuns.size(), fHeads);
+}
+
+// Opens runs [begin, end) and puts the first record of each in heads
+template <class Record, class Less>
+bool ExternalSorter<Record, Less>::openRuns(size_t begin, size_t end, size_t bufRecords,
+                                            priority_queue<Head, vector<Head>, HeadOrder> & heads)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		Head h;
+		h.second = i;
+		if (! fRuns[i]->openForReading(bufRecords))
+			return readFailed(fRuns[i]);
+		if (fRuns[i]->next(h.first))
+			heads.push(h);
+	}
+	return true;
+}
+
+// Merges runs [begin, end) into one, which is added to merged.  The runs are removed as they
+// are read; a single run is moved as it is.
+template <class Record, class Less>
+bool ExternalSorter<Record, Less>::mergeRuns(size_t begin, size_t end, vector<RecordFile<Record> *> & merged)
+{
+	if (end - begin == 1)
+	{
+		merged.push_back(fRuns[begin]);
+		fRuns[begin] = 0;
+		return true;
+	}
+	RecordFile<Record> * out = new RecordFile<Record>(RecordFile<Record>::tempName(fTempDir, fLabel));
+	merged.push_back(out);
+
+	// the runs and the merged run each get an equal share of the memory
+	const size_t bufRecords = max(fCapacity / (end - begin + 1), (size_t) 1);
+	priority_queue<Head, vector<Head>, HeadOrder> heads((HeadOrder(fLess)));
+	if (! openRuns(begin, end, bufRecords, heads))
+		return false;
+	vector<Record> buf;
+	buf.reserve(bufRecords);
+	bool ok = true;
+	while (ok && ! heads.empty())
+	{
+		Head h = heads.top();
+		heads.pop();
+		buf.push_back(h.first);
+		if (buf.size() == bufRecords)
+		{
+			ok = out->write(buf.data(), buf.size());
+			buf.clear();
+		}
+		RecordFile<Record> * run = fRuns[h.second];
+		if (run->next(h.first))
+			heads.push(h);
+		else if (run->failed())
+			return readFailed(run);
+		else
+			run->remove();
+	}
+	if (! ok || ! out->write(buf.data(), buf.size()) || ! out->close())
+	{
+		cerr << "Couldn't write temporary file '" << out->name() << "'" << endl;
+		fFailed = true;
+	}
+	return ! fFailed;
+}
+
+template <class Record, class Less>
+bool ExternalSorter<Record, Less>::readFailed(RecordFile<Record> * run)
+{
+	cerr << "Couldn't read back temporary file '" << run->name() << "'" << endl;
+	fFailed = true;
+	return false;
+}
+
+template <class Record, class Less>
+bool ExternalSorter<Record, Less>::next(Record & r)
+{
+	if (fRuns.empty())
+	{
+		if (fNext == fBuf.size())
+			return false;
+		r = fBuf[fNext++];
+		return true;
+	}
+	if (fHeads.empty())
+		return false;
+	Head h = fHeads.top();
+	fHeads.pop();
+	r = h.first;
+	RecordFile<Record> * run = fRuns[h.second];
+	if (run->next(h.first))
+		fHeads.push(h);
+	else if (run->failed())
+		return readFailed(run);
+	else
+		run->remove();
+	return true;
+}
+
+#endif
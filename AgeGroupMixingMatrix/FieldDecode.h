@@ -0,0 +1,31 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FIELD_DECODE_H
+#define FIELD_DECODE_H 1
+
+// Allocation-free conversion of the text in [begin, end) to a number.
+// The text need not be null-terminated.  Leading and trailing blanks are allowed;
+// anything else that isn't part of the number makes the conversion fail.
+// On failure the functions return false and leave the value unchanged.
+
+bool decodeLong(const char * begin, const char * end, long & val);
+bool decodeDouble(const char * begin, const char * end, double & val);
+
+// And back: write the text of val at p and return the end of it.  encodeDouble() writes
+// exactly what printf's "%g" (and an ostream with default settings) would; p needs room
+// for kMaxEncodedLength characters.
+const int kMaxEncodedLength = 32;
+char * encodeLong(long val, char * p);
+char * encodeDouble(double val, char * p);
+
+#endif
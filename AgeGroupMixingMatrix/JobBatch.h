@@ -0,0 +1,72 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef JOB_BATCH_H
+#define JOB_BATCH_H 1
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "ContactJob.h"
+
+using namespace std;
+
+// Many jobs, e.g. every state, run by one process on a pool of worker threads.
+// The jobs come from a manifest: a comma-separated file whose first line (after any
+// blank lines or lines starting with '#') names the columns
+//	state,population,network,output,age_groups[,threads][,combined][,age_schemes]
+// followed by one line per job.  The network is a list of files or glob patterns separated
+// by blanks or semicolons, as in a configuration file; empty means contacts within households.
+// Likewise age_groups may name several schemes, which age_schemes, a file, may define.
+//
+// The pool has one worker per core (fewer if jobs ask for several threads), and a job
+// starts only when its estimated memory fits in what the system has available, though
+// one job always runs.  Jobs fail independently, and may use different age group schemes.
+
+class JobBatch {
+	public :
+
+	JobBatch(void) {};
+
+	bool readManifest(const string & fName);   // false, after reporting why, if it's malformed
+	size_t size(void) const {return fJobs.size();};
+
+	// Returns the number of jobs that failed.  maxWorkers = 0 means one per core.
+	int run(int maxWorkers = 0);
+
+	// one line per job: name, status, and times in seconds
+	void report(ostream & os) const;
+	// every job's RunStats, as JSON if the name ends in ".json" and CSV otherwise
+	bool writeStats(const string & fName) const;
+
+	protected :
+
+	struct Entry {
+		Entry(void) : memEstimate(0), status(-1) {};
+		ContactJob job;
+		size_t memEstimate;  // bytes
+		int status;          // runJob() result; -1 if it didn't finish
+		string message;      // why, if it threw
+		RunStats stats;
+	};
+
+	vector<Entry> fJobs;
+
+	void runPool(int numWorkers, size_t memAvailable);
+	void runEntry(Entry & e);
+
+	static size_t availableMemory(void);
+	static size_t estimateMemory(const ContactJob & job);
+};
+
+#endif
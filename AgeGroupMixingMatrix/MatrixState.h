@@ -0,0 +1,66 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MATRIX_STATE_H
+#define MATRIX_STATE_H 1
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+using namespace std;
+
+// Everything a ContactTensor has accumulated, exactly: raw counts, durations in seconds and
+// population sizes, with the county names and the age group scheme they belong to.  Unlike the
+// matrices written as text, states can be reloaded and added to.
+//
+// The file is native-endian: a header, the county names (each a uint32_t length and the
+// characters), then the counts, durations and population sizes, county-major as in the
+// tensor, and the number of duration bins, 0 if there are no distributions, followed by
+// the bins and the counts of short contacts, then the number of bootstrap replicates, 0 if
+// there are none, and their seed, followed by the replicates' counts and durations.  The
+// header holds a checksum of everything after it.  Version 1 files, which end with the
+// population sizes, and version 2 files, which end with the distributions, are read too.
+//
+//	MatrixState state;
+//	contacts.save(state, countyNames);
+//	if (! state.write(fName)) ...
+
+struct MatrixState {
+	MatrixState(void) : schemeChecksum(0), numGroups(0), numReplicates(0), bootstrapSeed(0) {};
+
+	string scheme;             // the age groups' name
+	uint32_t schemeChecksum;   // see AgeGroups.h
+	int numGroups;
+	vector<string> counties;   // names, by the tensor's index
+	vector<int64_t> counts;    // [county][src age group][dst age group]
+	vector<double> durations;  // seconds
+	vector<int64_t> popSize;   // [county][age group]
+	vector<int64_t> durationBins;   // [county][cell][bin], empty without distributions
+	vector<int64_t> shortCounts;    // [county][cell]; see DurationHistogram.h
+	uint32_t numReplicates;         // see Bootstrap.h
+	uint64_t bootstrapSeed;
+	vector<int64_t> repCounts;      // [county][cell][replicate]
+	vector<double> repDurations;
+
+	bool hasDistributions(void) const {return ! durationBins.empty();};
+
+	// Appended to buf, or read from p, which is left just past it.  False, after a message to
+	// cerr naming where it came from, if it's damaged.
+	void encode(string & buf) const;
+	bool decode(const char * & p, const char * end, const string & where);
+
+	bool write(const string & fName) const;   // atomically; see writeFileAtomically()
+	bool read(const string & fName);          // false, after a message to cerr, if it can't
+};
+
+#endif
@@ -0,0 +1,78 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MATRIX_WRITER_H
+#define MATRIX_WRITER_H 1
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "ContactMatrix.h"
+
+using namespace std;
+
+// Writes many small output files quickly.  Each matrix is formatted into memory by the
+// caller's thread and handed to a small pool of I/O threads, which write each file with
+// a single write(2) while the next one is being formatted.  When more than maxQueued bytes
+// are waiting, write() waits too.
+//
+//	MatrixWriter out;
+//	out.write(outFName + ".txt", contacts.state());
+//	...
+//	if (! out.finish()) ...     // after reporting the files that couldn't be written
+
+class MatrixWriter {
+	public :
+
+	MatrixWriter(int numThreads = 2, size_t maxQueued = 64 << 20);
+	~MatrixWriter();
+
+	template <class Scheme>
+	void write(const string & fName, const ContactMatrix<Scheme> & cm)
+		{string contents; cm.format(contents); write(fName, contents);};
+	void write(const string & fName, string & contents);   // takes contents, leaving it empty
+	bool finish(void);            // waits for everything to be written
+
+	long bytes(void) const {return fBytes;};   // formatted so far
+
+	protected :
+
+	struct File {
+		string name;
+		string contents;
+	};
+
+	vector<thread> fThreads;
+	mutex fMutex;
+	condition_variable fWork;     // something to write, or finishing
+	condition_variable fRoom;     // the queue has shrunk
+	deque<File> fQueue;
+	size_t fQueued;               // bytes
+	size_t fMaxQueued;
+	bool fFinishing;
+	vector<string> fFailed;
+	long fBytes;
+
+	void ioThread(void);
+	static bool writeFile(const string & fName, const string & contents);
+
+	private :
+
+	MatrixWriter(const MatrixWriter &);
+	MatrixWriter & operator=(const MatrixWriter &);
+};
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PERSON_TABLE_H
+#define PERSON_TABLE_H 1
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <stdint.h>
+
+using namespace std;
+
+typedef long personIdType;
+typedef uint16_t countyIdType;
+
+// Compact store of everyone in the population, keyed by person id.
+// Each person is reduced to a one-byte age group index and a small county index;
+// county FIPS strings are interned once and can be recovered with countyName().
+//
+// add() everyone, then finalize() before any lookups.  When the ids are dense enough
+// (kMaxDenseRatio) the records live in a flat array indexed by (pid - minimum pid);
+// otherwise the ids are sorted and found by binary search.  Either way a lookup never
+// inserts anything, unlike map::operator[]; callers count the ids they don't find.
+
+class PersonTable {
+	public :
+
+	struct Person {
+		uint8_t ageGroup;
+		countyIdType county;
+	};
+
+	PersonTable(void) : fMinId(0), fSize(0), fDense(true), fFinal(false) {};
+
+	// kNoCounty, after a message to cerr, if there are already kMaxCounties
+	countyIdType internCounty(const string & fips);
+	const string & countyName(int county) const {return fCountyNames[county];};
+	int numCounties(void) const {return fCountyNames.size();};
+
+	void add(personIdType pid, int ageGroup, countyIdType county);
+	void finalize(void);
+
+	const Person * find(personIdType pid) const;  // 0 if pid isn't in the table
+
+	long size(void) const {return fSize;};
+	bool isDense(void) const {return fDense;};
+	size_t bytes(void) const {return fIds.capacity() * sizeof(personIdType) + fPeople.capacity() * sizeof(Person);};
+
+	enum {kNoAgeGroup = 0xff, kMaxCounties = 0xffff, kNoCounty = kMaxCounties};
+	static const long kMaxDenseRatio = 3;  // a dense slot costs a third of a sorted entry
+
+	protected :
+
+	vector<personIdType> fIds;   // sorted; empty when dense
+	vector<Person> fPeople;
+	personIdType fMinId;
+	long fSize;
+	bool fDense;
+	bool fFinal;
+
+	map<string, countyIdType> fCountyIds;
+	vector<string> fCountyNames;
+};
+
+inline const PersonTable::Person * PersonTable::find(personIdType pid) const
+{
+	if (fDense)
+	{
+		unsigned long offset = (unsigned long) (pid - fMinId);
+		if (offset >= fPeople.size() || fPeople[offset].ageGroup == kNoAgeGroup)
+			return 0;
+		return &fPeople[offset];
+	}
+	vector<personIdType>::const_iterator it = lower_bound(fIds.begin(), fIds.end(), pid);
+	if (it == fIds.end() || *it != pid)
+		return 0;
+	return &fPeople[it - fIds.begin()];
+}
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef POPULATION_READER_H
+#define POPULATION_READER_H 1
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <functional>
+#include <stdint.h>
+
+#include "CSVParser.h"
+
+using namespace std;
+
+// Everyone in a population (persontrait) file, one record at a time, in file order.
+//
+// Parsing the CSV file is slow, and the population changes far less often than the
+// networks, so the parsed records are cached in a binary snapshot next to the population
+// file: <population file>.<age groups>.snap.  The snapshot's header records the size,
+// modification time and a checksum of the population file, and the age group scheme.
+// If it matches, the records are read straight from the memory-mapped snapshot; otherwise
+// the CSV file is parsed and the snapshot is (re)written as a side effect.  A snapshot is
+// written to a temporary file and renamed only once the whole population has been read
+// without errors, so concurrent runs never see a partial one.
+//
+//	PopulationReader pop(popFile, CDCAgeGroups());
+//	PopulationReader::Record r;
+//	while (pop.next(r))
+//		... pop.countyName(r.county) ...
+//	if (pop.failed()) ...
+//
+// A snapshot or an uncompressed CSV file can also be read in pieces, e.g. in separate threads:
+//	vector<pair<size_t, size_t> > ranges = pop.splitRanges(numThreads);
+//	PopulationReader * piece = pop.piece(ranges[i]);
+// Each piece numbers its counties for itself.  Nothing read in pieces is saved in a snapshot.
+
+class PopulationReader {
+	public :
+
+	// a snapshot is native-endian, 24 bytes per person
+	struct Record {
+		int64_t pid;
+		int64_t hid;       // -1 if the population file has no household ids
+		uint16_t county;   // this reader's index; see countyName()
+		uint8_t ageGroup;  // the scheme's ageToIndex() of the age (group)
+		uint8_t pad[5];
+	};
+
+	// What the reader needs to know about an age group scheme (see AgeGroups.h)
+	struct AgeColumn {
+		template <class Scheme>
+		AgeColumn(const Scheme & s)
+			: scheme(s.name()), numGroups(s.numGroups()), checksum(s.checksum()), column(s.ageColumn()),
+			  ageToIndex([s](const char * p, size_t len) {return s.ageToIndex(p, len);}) {};
+		string scheme;
+		int numGroups;
+		uint32_t checksum;
+		string column;
+		function<int(const char *, size_t)> ageToIndex;
+	};
+
+	PopulationReader(const string & popFile, const AgeColumn & ages, bool useSnapshot = true);
+	~PopulationReader();
+
+	bool next(Record & r);          // false at the end or after an error
+	bool failed(void) const {return fFailed;};
+	bool hasHouseholds(void) const {return fHasHid;};
+	bool fromSnapshot(void) const {return fRecords != 0;};
+
+	// Split the people not yet read into (at most) n ranges, or none if this reader can't be split
+	vector<pair<size_t, size_t> > splitRanges(int n) const;
+	// A reader for just the people in a range, to be deleted before this one
+	PopulationReader * piece(const pair<size_t, size_t> & range) const;
+
+	// counties are numbered in order of first appearance
+	const string & countyName(int county) const {return fCountyNames[county];};
+	int numCounties(void) const {return fCountyNames.size();};
+
+	static string snapshotName(const string & popFile, const string & scheme);
+
+	protected :
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t numGroups;
+		char ageGroups[16];       // the scheme's name
+		uint64_t sourceSize;      // of the population file
+		int64_t sourceMTime;      // nanoseconds
+		uint32_t sourceChecksum;  // adler32 of its first and last megabytes
+		uint32_t hasHid;
+		uint64_t numRecords;      // which follow the header
+		uint64_t countyOffset;    // of the county names, each a uint32_t length and the characters
+		uint32_t numCounties;
+		uint32_t schemeChecksum;  // of a scheme defined at run time
+	};
+	Header fSource;           // describes the population file as it is now
+
+	string fPopFile;
+	AgeColumn fAges;
+	bool fFailed;
+	bool fHasHid;
+	vector<string> fCountyNames;
+
+	// reading a snapshot; a piece shares the records of the whole
+	const char * fMap;
+	size_t fMapLen;
+	const Record * fRecords;
+	uint64_t fNumRecords;
+	uint64_t fNext;
+
+	// reading the CSV file and writing a snapshot
+	CSVParser * fCSV;
+	int fIdCol, fHidCol, fAgeCol, fFipsCol;
+	map<string, uint16_t> fCountyIds;
+	int fLastCounty;
+	ofstream * fSnapOut;
+	string fSnapTemp;
+	uint64_t fNumWritten;
+
+	bool mapSnapshot(void);
+	void openCSV(bool writeSnapshot);
+	bool nextCSV(Record & r);
+	void finishSnapshot(void);
+	void abandonSnapshot(void);
+	bool describeSource(Header & h) const;
+	bool sameSource(const Header & h) const;
+
+	private :
+
+	PopulationReader(const PopulationReader & whole, const pair<size_t, size_t> & range);
+	PopulationReader(const PopulationReader &);
+	PopulationReader & operator=(const PopulationReader &);
+};
+
+#endif
@@ -0,0 +1,85 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RUN_STATS_H
+#define RUN_STATS_H 1
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+// What one phase of a run (reading the population, say) did and what it cost.
+// CPU time and peak RSS are the whole process's, so when several jobs share a process
+// they include the others' too.
+struct PhaseStats {
+	PhaseStats(const string & n = "") : name(n), wall(0), cpu(0), rows(0), bytes(0), peakRSS(0) {};
+
+	string name;
+	double wall;     // seconds
+	double cpu;      // user + system seconds
+	long rows;       // records read or written; 0 if that means nothing for the phase
+	long bytes;
+	long peakRSS;    // bytes, the high-water mark when the phase ended
+
+	double rowsPerSec(void) const {return (wall > 0) ? rows / wall : 0;};
+	double bytesPerSec(void) const {return (wall > 0) ? bytes / wall : 0;};
+
+	static double cpuSeconds(bool thisThread = false);
+	static long maxRSS(void);
+};
+
+// The phases of a run, in order.  Either time them here:
+//	RunStats stats("VA");
+//	stats.start("population");
+//	...
+//	stats.stop(numPeople, fileSize);
+// or add() ones measured elsewhere.  A summary can be logged, or written as JSON or CSV
+// to compare runs on different populations and machines.
+
+class RunStats {
+	public :
+
+	RunStats(const string & label = "") : fLabel(label), fRunning(false) {};
+
+	void start(const string & phase);           // stops the current phase, if any
+	void stop(long rows = 0, long bytes = 0);
+	void add(const PhaseStats & phase) {fPhases.push_back(phase);};
+
+	const string & label(void) const {return fLabel;};
+	void setLabel(const string & label) {fLabel = label;};
+	const vector<PhaseStats> & phases(void) const {return fPhases;};
+	PhaseStats * find(const string & phase);     // the latest of that name, or 0
+	double seconds(const string & phase) const;  // of all the phases of that name
+	PhaseStats total(void) const;
+
+	void log(ostream & os) const;                // a table for people
+	void writeJSON(ostream & os) const;
+	void writeCSV(ostream & os, bool header = true) const;
+	// JSON if the name ends in ".json", CSV otherwise.  False, after a message, on failure.
+	bool write(const string & fName) const;
+	static bool isJSONName(const string & fName);
+
+	static const char * kCSVHeader;
+
+	protected :
+
+	string fLabel;
+	vector<PhaseStats> fPhases;
+	bool fRunning;
+	chrono::steady_clock::time_point fStart;
+	double fStartCPU;
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include <set>     
 #include <list>
 #include <queue>
+#include <thread>
 
 #include "BitArray.h"
 // class BitArray;
@@ -44,15 +45,53 @@ bool resetCout(const string & fname, int id=-1);
 bool resetCerr(const string & fname, int id=-1);
 bool resetClog(const string & fname, int id=-1);
 
+// Make cout, cerr and clog safe to share among threads.  Each thread's output is held
+// until the end of a line and then written whole, preceded by that thread's prefix.
+// Call after any of the resets above; the streams keep writing to their current buffers.
+void synchronizeLogs(void);
+void setLogPrefix(const string & prefix);  // for the calling thread only
+const string & logPrefix(void);            // the calling thread's
+
+// Like thread(f, args...), but the new thread logs with the prefix of the thread starting it
+template <class F, class... Args>
+thread prefixedThread(F f, Args... args)
+{
+	const string prefix = logPrefix();
+	return thread([prefix](F f, Args... args) {setLogPrefix(prefix); bind(f, args...)();}, f, args...);
+}
+
 // file testing
 bool fileExists(const string & fname);
 bool fileIsEmpty(const string & fname);
 bool fileIsReadable(const string & fname);
 bool fileIsWritable(const string & fname);
+long fileSize(const string & fname);   // 0 if it doesn't exist
+// Writes a temporary file in the same directory, flushes it to disk and renames it, so
+// readers see either the old contents or all of the new.  False if any step fails.
+bool writeFileAtomically(const string & fname, const string & contents);
+
+// The items in a list separated by any of separators, without the blanks around them; by
+// default commas, semicolons or newlines, so a file name may contain blanks
+vector<string> splitList(const string & spec, const char * separators = ",;\n");
+// The files named in such a list.  Each item may be a glob pattern; its matches are sorted.
+// A pattern that matches nothing is kept as is.
+vector<string> expandFileList(const string & spec);
 
 uint32_t adler32(const char *data, size_t len);
 
 double myDoubleRandom(void);  // uniform in the closed interval [0,1]
 
+// Counter-based random numbers: 64 random bits that are a function only of key and counter
+// (SplitMix64's output function applied to them), so threads need no shared generator and
+// the numbers don't depend on the order in which they're drawn
+inline uint64_t mix64(uint64_t x)
+{
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+inline uint64_t counterRandom(uint64_t key, uint64_t counter)
+	{return mix64(key + (counter + 1) * 0x9e3779b97f4a7c15ULL);}
+
 long pickRandomIndex(const vector<double> & weights, double sumWeights);
 #endif
@@ -0,0 +1,246 @@
+// Copyright 2020 Stephen Eubank, University of Virginia.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SYNTHETIC_POPULATION_H
+#define SYNTHETIC_POPULATION_H 1
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+// A synthetic population and contact network in the formats Contacts reads, for benchmarks.
+// The output depends only on the sizes and the seed.
+//
+// People are numbered 0, 1, ... and live in households whose sizes follow the US census
+// distribution (28% of one person, 35% of two, ...); a household's members are consecutive.
+// Counties are numbered like Virginia's (51001, 51003, ...), with sizes falling off as 1/rank.
+// Each contact picks a source uniformly; its target is in the same household 30% of the time,
+// the same county 50% of the time and anywhere otherwise.  Household contacts last hours,
+// the others minutes to hours.  The network is streamed, so its size is limited only by disk.
+//
+//	SyntheticPopulation pop(numPeople, seed);
+//	pop.writePopulation("person.txt");
+//	pop.writeNetwork("net", numEdges);
+
+class SyntheticPopulation {
+	public :
+
+	SyntheticPopulation(long numPeople, uint64_t seed = 1);
+
+	long numPeople(void) const {return fNumPeople;};
+	long numHouseholds(void) const {return fHHStart.size();};
+	int numCounties(void) const {return fCountyStart.size();};
+
+	bool writePopulation(const string & fName);
+	bool writeNetwork(const string & fName, long numEdges);
+
+	protected :
+
+	// splitmix64: tiny, fast, and the same everywhere
+	struct Random {
+		Random(uint64_t seed) : fState(seed) {};
+		uint64_t next(void)
+		{
+			uint64_t z = (fState += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		};
+		long below(long n) {return (long) (next() % (uint64_t) n);};
+		double uniform(void) {return (next() >> 11) * (1.0 / 9007199254740992.0);};
+		uint64_t fState;
+	};
+
+	// a buffered writer that formats integers itself
+	class Writer {
+		public :
+		Writer(const string & fName) : fFile(fopen(fName.c_str(), "w")), fBuf(1 << 20), fLen(0) {};
+		~Writer() {close();};
+		bool ok(void) const {return fFile != 0;};
+		void put(char c) {if (fLen == fBuf.size()) flush(); fBuf[fLen++] = c;};
+		void put(const char * s) {for ( ; *s; s++) put(*s);};
+		void put(long v)
+		{
+			char digits[24];
+			int n = 0;
+			if (v < 0) {put('-'); v = -v;}
+			do {digits[n++] = '0' + v % 10; v /= 10;} while (v > 0);
+			while (n > 0)
+				put(digits[--n]);
+		};
+		void put(double v, int decimals)
+		{
+			char s[64];
+			snprintf(s, sizeof(s), "%.*f", decimals, v);
+			put(s);
+		};
+		bool close(void)
+		{
+			if (! fFile)
+				return false;
+			flush();
+			bool rtn = (ferror(fFile) == 0);
+			rtn = (fclose(fFile) == 0) && rtn;
+			fFile = 0;
+			return rtn;
+		};
+		protected :
+		void flush(void) {if (fFile && fLen) fwrite(&fBuf[0], 1, fLen, fFile); fLen = 0;};
+		FILE * fFile;
+		vector<char> fBuf;
+		size_t fLen;
+	};
+
+	long fNumPeople;
+	uint64_t fSeed;
+	vector<long> fHHStart;      // first member of each household
+	vector<long> fCountyStart;  // first member of each county, which holds whole households
+
+	long household(long pid) const
+		{return upper_bound(fHHStart.begin(), fHHStart.end(), pid) - fHHStart.begin() - 1;};
+	long householdEnd(long hh) const
+		{return (hh + 1 < (long) fHHStart.size()) ? fHHStart[hh + 1] : fNumPeople;};
+	int county(long pid) const
+		{return upper_bound(fCountyStart.begin(), fCountyStart.end(), pid) - fCountyStart.begin() - 1;};
+	long countyEnd(int c) const
+		{return (c + 1 < (int) fCountyStart.size()) ? fCountyStart[c + 1] : fNumPeople;};
+	static int age(Random & rand, int member, int size);
+	static char ageGroup(int age);
+};
+
+inline SyntheticPopulation::SyntheticPopulation(long numPeople, uint64_t seed)
+	: fNumPeople(max(numPeople, 1L)), fSeed(seed)
+{
+	// households
+	static const double kSizeCDF[] = {0.28, 0.63, 0.78, 0.91, 0.97, 0.99, 1.0};
+	Random rand(fSeed);
+	for (long pid = 0; pid < fNumPeople; )
+	{
+		fHHStart.push_back(pid);
+		const double u = rand.uniform();
+		int size = 1;
+		while (size < 7 && u > kSizeCDF[size - 1])
+			size++;
+		pid += size;
+	}
+
+	// counties of about 1/rank of the people, in whole households; Virginia has 133
+	const int numCounties = (int) max(1L, min(133L, fNumPeople / 5000));
+	double total = 0;
+	for (int c = 0; c < numCounties; c++)
+		total += 1.0 / (c + 1);
+	double share = 0;
+	for (int c = 0; c < numCounties; c++)
+	{
+		long hh = (long) (fHHStart.size() * share / total);
+		if (fCountyStart.empty() || fHHStart[hh] > fCountyStart.back())
+			fCountyStart.push_back(fHHStart[hh]);
+		share += 1.0 / (c + 1);
+	}
+}
+
+// the first member is an adult, the second usually one too, the rest usually children
+inline int SyntheticPopulation::age(Random & rand, int member, int size)
+{
+	if (member == 0)
+		return (size <= 2) ? 18 + rand.below(73) : 20 + rand.below(40);
+	if (member == 1 && rand.uniform() < 0.8)
+		return 18 + rand.below(60);
+	return (rand.uniform() < 0.85) ? rand.below(18) : 18 + rand.below(73);
+}
+
+inline char SyntheticPopulation::ageGroup(int age)
+{
+	return (age < 5) ? 'p' : (age < 18) ? 's' : (age < 50) ? 'a' : (age < 65) ? 'o' : 'g';
+}
+
+inline bool SyntheticPopulation::writePopulation(const string & fName)
+{
+	Writer w(fName);
+	if (! w.ok())
+		return false;
+	w.put("synthetic population\n");
+	w.put("pid,hid,age,age_group,gender,county_fips,home_latitude,home_longitude\n");
+	Random rand(fSeed + 1);
+	for (long hh = 0; hh < (long) fHHStart.size(); hh++)
+	{
+		const long begin = fHHStart[hh];
+		const long end = householdEnd(hh);
+		const int c = county(begin);
+		const double lat = 36.6 + 0.02 * (c % 50) + 0.01 * rand.uniform();
+		const double lon = -83.0 + 0.05 * (c / 50 * 25 + c % 25) + 0.01 * rand.uniform();
+		for (long pid = begin; pid < end; pid++)
+		{
+			const int a = age(rand, pid - begin, end - begin);
+			w.put(pid); w.put(',');
+			w.put(hh); w.put(',');
+			w.put((long) a); w.put(',');
+			w.put(ageGroup(a)); w.put(',');
+			w.put((long) (1 + rand.below(2))); w.put(',');
+			w.put((long) (51001 + 2 * c)); w.put(',');
+			w.put(lat, 6); w.put(',');
+			w.put(lon, 6); w.put('\n');
+		}
+	}
+	return w.close();
+}
+
+inline bool SyntheticPopulation::writeNetwork(const string & fName, long numEdges)
+{
+	Writer w(fName);
+	if (! w.ok())
+		return false;
+	w.put("synthetic network\n");
+	w.put("targetPID,targetActivity,sourcePID,sourceActivity,duration\n");
+	Random rand(fSeed + 2);
+	for (long i = 0; i < numEdges; i++)
+	{
+		const long src = rand.below(fNumPeople);
+		const double u = rand.uniform();
+		long dst;
+		long srcAct, dstAct, dur;
+		const long hh = household(src);
+		const long hhSize = householdEnd(hh) - fHHStart[hh];
+		if (u < 0.3 && hhSize > 1)
+		{
+			dst = fHHStart[hh] + (src - fHHStart[hh] + 1 + rand.below(hhSize - 1)) % hhSize;
+			srcAct = dstAct = 1;
+			dur = 3600 + rand.below(12 * 3600);
+		}
+		else
+		{
+			if (u < 0.8)
+			{
+				const int c = county(src);
+				dst = fCountyStart[c] + rand.below(countyEnd(c) - fCountyStart[c]);
+			}
+			else
+				dst = rand.below(fNumPeople);
+			srcAct = 2 + rand.below(5);
+			dstAct = 2 + rand.below(5);
+			dur = 300 + rand.below(8 * 3600);
+		}
+		w.put(dst); w.put(',');
+		w.put(dstAct); w.put(',');
+		w.put(src); w.put(',');
+		w.put(srcAct); w.put(',');
+		w.put(dur); w.put('\n');
+	}
+	return w.close();
+}
+
+#endif